@@ -37,6 +37,7 @@
 #include "../tpl/weighted_vector_tpl.h"
 #include "../tpl/vector_tpl.h"
 #include "hausbauer.h"
+#include "wegbauer.h"
 
 karte_ptr_t hausbauer_t::welt;
 
@@ -349,6 +350,7 @@ void hausbauer_t::new_world()
 
 void hausbauer_t::remove( player_t *player, const gebaeude_t *gb, bool map_generation ) //gebaeude = "building" (Babelfish)
 {
+	way_builder_t::map_changed();
 	const building_tile_desc_t *tile  = gb->get_tile();
 	const building_desc_t *bdsc = tile->get_desc();
 	const uint8 layout = tile->get_layout();
@@ -551,6 +553,7 @@ void hausbauer_t::remove( player_t *player, const gebaeude_t *gb, bool map_gener
 
 gebaeude_t* hausbauer_t::build(player_t* player, koord3d pos, int org_layout, const building_desc_t* desc, void* param)
 {
+	way_builder_t::map_changed();
 	gebaeude_t* first_building = NULL;
 	koord k;
 	koord dim;
@@ -769,6 +772,7 @@ gebaeude_t* hausbauer_t::build(player_t* player, koord3d pos, int org_layout, co
 
 gebaeude_t *hausbauer_t::build_station_extension_depot(player_t *player, koord3d pos, int built_layout, const building_desc_t *desc, void *param)
 {
+	way_builder_t::map_changed();
 	uint8 corner_layout = 6; // assume single building (for more than 4 layouts)
 
 	// adjust layout of neighbouring building
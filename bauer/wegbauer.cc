@@ -60,6 +60,7 @@
 
 #include "../gui/messagebox.h"
 #include "../tpl/stringhashtable_tpl.h"
+#include "../tpl/flat_hashtable_tpl.h"
 
 #include "../gui/minimap.h" // for debugging
 #include "../gui/tool_selector.h"
@@ -1596,6 +1597,8 @@ void way_builder_t::check_for_bridge(const grund_t* parent_from, const grund_t*
 way_builder_t::way_builder_t(player_t* player) : next_gr(32)
 {
 	player_builder     = player;
+	desc = NULL;
+	reuse_search = false;
 	bautyp = strasse;   // kann mit init_builder() gesetzt werden
 	maximum = 2000;// CA $ PER TILE
 	overtaking_mode = twoway_mode;
@@ -1687,6 +1690,191 @@ void get_mini_maxi( const vector_tpl<koord3d> &ziel, koord3d &mini, koord3d &max
 }
 
 
+/**
+ * A route going on straight in @p dir from @p pos must turn at least once,
+ * if this line misses the cuboid. Going on straight only shortens the line,
+ * so adding a curve for this keeps the A* estimate consistent.
+ */
+static bool needs_curve_to_target( const koord3d &pos, ribi_t::ribi dir, const koord3d &mini, const koord3d &maxi )
+{
+	if(  !ribi_t::is_single(dir)  ) {
+		// start tile or within a turn
+		return false;
+	}
+	const koord zv(dir);
+	if(  zv.x == 0  ) {
+		return pos.x < mini.x  ||  pos.x > maxi.x  ||  (zv.y > 0 ? pos.y > maxi.y : pos.y < mini.y);
+	}
+	return pos.y < mini.y  ||  pos.y > maxi.y  ||  (zv.x > 0 ? pos.x > maxi.x : pos.x < mini.x);
+}
+
+
+/**
+ * The tiles closed by the last search in preview mode, see way_builder_t::set_reuse_search().
+ * Only positions are kept (the nodes belong to route_t). The tree is only
+ * valid until ways, buildings or the terrain change, see way_builder_t::map_changed().
+ */
+struct kept_search_t
+{
+	struct node_t {
+		koord3d pos;
+		uint32 parent; ///< index in nodes, UINT32_MAX_VALUE at the start
+		uint32 g;
+		uint8 dir;
+		uint8 flag;
+	};
+
+	class koord3d_hash_t {
+	public:
+		static uint32 hash(const koord3d key) { return ((uint32)(uint16)key.y << 16 | (uint16)key.x) ^ ((uint32)(uint8)key.z << 24); }
+		static sint32 comp(const koord3d key1, const koord3d key2) { return key1 == key2 ? 0 : 1; }
+	};
+
+	vector_tpl<node_t> nodes;
+	/// can hold many thousand tiles, too many for the bags of hashtable_tpl
+	flat_hashtable_tpl<koord3d, uint32, koord3d_hash_t> index;
+
+	// settings the tree was searched with
+	vector_tpl<koord3d> start;
+	koord3d mini, maxi; ///< target cuboid, the tiles in there got the end penalties
+	uint32 map_changes; ///< map_change_count when searched
+	const player_t *player;
+	way_builder_t::bautyp_t bautyp;
+	const way_desc_t *desc;
+	const tunnel_desc_t *tunnel_desc;
+	const bridge_desc_t *bridge_desc;
+	uint8 keep_flags;
+	uint32 maximum;
+	bool valid;
+
+	kept_search_t() : valid(false) {}
+
+	void clear()
+	{
+		nodes.clear();
+		index.clear();
+		start.clear();
+		valid = false;
+	}
+
+	void add(const route_t::ANode *node)
+	{
+		uint32 parent = UINT32_MAX_VALUE;
+		if(  node->parent  ) {
+			if(  const uint32 *p = index.access( node->parent->gr->get_pos() )  ) {
+				parent = *p;
+			}
+		}
+		node_t n = { node->gr->get_pos(), parent, node->g, node->dir, (uint8)node->count };
+		index.set( n.pos, nodes.get_count() );
+		nodes.append(n);
+	}
+};
+
+static kept_search_t last_search;
+
+/// counts the changes of ways, buildings and terrain, for the validity of last_search
+static uint32 map_change_count = 0;
+
+
+void way_builder_t::clear_last_search()
+{
+	last_search.clear();
+}
+
+
+void way_builder_t::map_changed()
+{
+	map_change_count++;
+}
+
+
+void way_builder_t::begin_last_search(const vector_tpl<koord3d> &start, const koord3d &mini, const koord3d &maxi)
+{
+	last_search.clear();
+	last_search.start = start;
+	last_search.mini = mini;
+	last_search.maxi = maxi;
+	last_search.map_changes = map_change_count;
+	last_search.player = player_builder;
+	last_search.bautyp = bautyp;
+	last_search.desc = desc;
+	last_search.tunnel_desc = tunnel_desc;
+	last_search.bridge_desc = bridge_desc;
+	last_search.keep_flags = keep_existing_ways | (keep_existing_faster_ways<<1) | (keep_existing_city_roads<<2) | (mark_way_for_upgrade_only<<3) | (forbid_crossings<<4);
+	last_search.maximum = maximum;
+	last_search.valid = true;
+}
+
+
+sint64 way_builder_t::calc_kept_route_cost(uint32 target, const koord3d &mini, const koord3d &maxi)
+{
+	const sint32 double_curve = welt->get_settings().way_count_double_curve;
+	sint64 cost = last_search.nodes[target].g;
+	for(  uint32 i = target;  last_search.nodes[i].parent != UINT32_MAX_VALUE;  i = last_search.nodes[i].parent  ) {
+		const kept_search_t::node_t &n = last_search.nodes[i];
+		if(  welt->lookup(n.pos) == NULL  ) {
+			return -1;
+		}
+		const bool in_target = calc_distance( n.pos, mini, maxi ) == 0;
+		if(  in_target  &&  (n.flag & terraform)  ) {
+			// no terraforming near target
+			return -1;
+		}
+		// the turns on the last tiles were penalised for the old target cuboid
+		if(  n.dir != last_search.nodes[n.parent].dir  ) {
+			const bool in_old_target = calc_distance( n.pos, last_search.mini, last_search.maxi ) == 0;
+			cost += ((sint64)in_target - (sint64)in_old_target) * double_curve;
+		}
+	}
+	return cost;
+}
+
+
+sint32 way_builder_t::reuse_last_search(const vector_tpl<koord3d> &start, const vector_tpl<koord3d> &ziel, const koord3d &mini, const koord3d &maxi)
+{
+	const uint8 keep_flags = keep_existing_ways | (keep_existing_faster_ways<<1) | (keep_existing_city_roads<<2) | (mark_way_for_upgrade_only<<3) | (forbid_crossings<<4);
+	if(  !last_search.valid  ||  last_search.map_changes != map_change_count  ||  last_search.player != player_builder  ||  last_search.bautyp != bautyp  ||
+	     last_search.desc != desc  ||  last_search.tunnel_desc != tunnel_desc  ||  last_search.bridge_desc != bridge_desc  ||  last_search.keep_flags != keep_flags  ||
+	     last_search.maximum != maximum  ||  last_search.start.get_count() != start.get_count()  ) {
+		return -1;
+	}
+	for(  uint32 i = 0;  i < start.get_count();  i++  ) {
+		if(  last_search.start[i] != start[i]  ) {
+			return -1;
+		}
+	}
+
+	// cheapest target already reached, with the end penalties for this target
+	uint32 best = UINT32_MAX_VALUE;
+	sint64 best_cost = -1;
+	for(koord3d const& i : ziel) {
+		const uint32 *n = last_search.index.access(i);
+		if(  n == NULL  ||  last_search.nodes[*n].parent == UINT32_MAX_VALUE  ) {
+			continue;
+		}
+		const sint64 cost = calc_kept_route_cost( *n, mini, maxi );
+		if(  cost >= 0  &&  (best_cost < 0  ||  cost < best_cost)  ) {
+			best = *n;
+			best_cost = cost;
+		}
+	}
+	// same conditions as for a target found by a fresh search
+	if(  best == UINT32_MAX_VALUE  ||  best_cost > (sint64)maximum  ) {
+		return -1;
+	}
+
+	for(  uint32 i = best;  i != UINT32_MAX_VALUE;  i = last_search.nodes[i].parent  ) {
+		const kept_search_t::node_t &n = last_search.nodes[i];
+		route.append(n.pos);
+		if(  n.flag & terraform  ) {
+			terraform_index.append(route.get_count()-1);
+		}
+	}
+	return (sint32)best_cost;
+}
+
+
 /**
  * this routine uses A* to calculate the best route
  * beware: change the cost and you will mess up the system!
@@ -1710,6 +1898,16 @@ sint32 way_builder_t::intern_calc_route(const vector_tpl<koord3d> &start, const
 	// calculate the minimal cuboid containing 'ziel'
 	koord3d mini, maxi;
 	get_mini_maxi( ziel, mini, maxi );
+	// every change of direction costs at least this
+	const uint32 min_curve_cost = max( 0, welt->get_settings().way_count_curve );
+
+	if(  reuse_search  ) {
+		const sint32 cost = reuse_last_search(start, ziel, mini, maxi);
+		if(  cost >= 0  ) {
+			return cost;
+		}
+		begin_last_search(start, mini, maxi);
+	}
 
 	// memory in static list ...
 	if(!route_t::MAX_STEP)
@@ -1786,6 +1984,10 @@ sint32 way_builder_t::intern_calc_route(const vector_tpl<koord3d> &start, const
 		gr = tmp->gr;
 		gr_pos = gr->get_pos();
 
+		if(  reuse_search  ) {
+			last_search.add(tmp);
+		}
+
 #ifdef DEBUG_ROUTES
 DBG_DEBUG("insert to close","(%i,%i,%i)  f=%i",gr->get_pos().x,gr->get_pos().y,gr->get_pos().z,tmp->f);
 #endif
@@ -1924,7 +2126,7 @@ DBG_DEBUG("insert to close","(%i,%i,%i)  f=%i",gr->get_pos().x,gr->get_pos().y,g
 			}
 
 
-			const uint32 new_f = new_g+new_dist;
+			const uint32 new_f = new_g + new_dist + (needs_curve_to_target( to->get_pos(), current_dir, mini, maxi ) ? min_curve_cost : 0);
 
 			if((step&0x03)==0) {
 				INT_CHECK( "wegbauer 1347" );
@@ -2271,8 +2473,11 @@ uint32 ms = dr_time();
 		INT_CHECK("wegbauer 1165");
 
 		if(cost2<0) {
-			// not successful: try backwards
+			// not successful: try backwards (keeping the search tree from the start)
+			const bool reuse = reuse_search;
+			reuse_search = false;
 			intern_calc_route(ziel,start);
+			reuse_search = reuse;
 			route_reversed = true;
 			return route_reversed;
 		}
@@ -3165,6 +3370,8 @@ DBG_MESSAGE("way_builder_t::build()","called, but no valid route.");
 		// no valid route here ...
 		return;
 	}
+	// the world changes: the kept search tree may not fit anymore
+	map_changed();
 	DBG_MESSAGE("way_builder_t::build()", "type=%d max_n=%d start=%d,%d end=%d,%d", bautyp, get_count() - 1, route.front().x, route.front().y, route.back().x, route.back().y);
 
 #ifdef DEBUG_ROUTES
@@ -172,6 +172,9 @@ private:
 
 	bool route_reversed;
 
+	/// preview mode, see set_reuse_search()
+	bool reuse_search;
+
 public:
 	/**
 	* This is the core routine for the way search
@@ -187,6 +190,15 @@ private:
 	void check_for_bridge(const grund_t* parent_from, const grund_t* from, const vector_tpl<koord3d> &ziel);
 
 	sint32 intern_calc_route(const vector_tpl<koord3d> &start, const vector_tpl<koord3d> &ziel);
+
+	/// @returns costs of the route to @p ziel (within @p mini .. @p maxi) taken from the kept search tree, -1 if not possible
+	sint32 reuse_last_search(const vector_tpl<koord3d> &start, const vector_tpl<koord3d> &ziel, const koord3d &mini, const koord3d &maxi);
+
+	/// costs of the kept route to node @p target with the end penalties of the new target cuboid, -1 if not allowed
+	sint64 calc_kept_route_cost(uint32 target, const koord3d &mini, const koord3d &maxi);
+
+	/// starts a new kept search tree with the current settings
+	void begin_last_search(const vector_tpl<koord3d> &start, const koord3d &mini, const koord3d &maxi);
 	void intern_calc_straight_route(const koord3d start, const koord3d ziel);
 
 	// runways need to meet some special conditions enforced here
@@ -239,6 +251,20 @@ public:
 
 	void set_mark_way_for_upgrade_only(bool yesno) { mark_way_for_upgrade_only = yesno; }
 
+	/**
+	 * Preview mode while dragging: the tiles closed by the search are kept,
+	 * and if the next search starts at the same place with the same settings,
+	 * targets already reached take their route from there without searching again.
+	 * The route may differ from a fresh search, hence not for building.
+	 */
+	void set_reuse_search(bool yesno) { reuse_search = yesno; }
+
+	/// forgets the search tree kept for set_reuse_search()
+	static void clear_last_search();
+
+	/// to be called when ways, buildings or the terrain changed, outdates the search tree kept for set_reuse_search()
+	static void map_changed();
+
 	void init_builder(bautyp_t wt, const way_desc_t * desc, const tunnel_desc_t *tunnel_desc=NULL, const bridge_desc_t *bridge_desc=NULL);
 
 	void set_maximum(uint32 n) { maximum = n; }
@@ -247,6 +273,8 @@ public:
 
 	void set_desc(const way_desc_t* way_desc) { desc = way_desc; }
 
+	const way_desc_t *get_desc() const { return desc; }
+
 	way_builder_t(player_t *player);
 
 	void calc_straight_route(const koord3d start, const koord3d ziel);
@@ -1582,7 +1582,7 @@ void grund_t::display_obj_all(const sint16 xpos, const sint16 ypos, const sint16
 	// no ways? - no clipping needed, avoid all the ribi-checks
 	if (ribi==ribi_t::none) {
 		// display background
-		const uint8 offset_vh = display_obj_bg( xpos, ypos, is_global, true, visible CLIP_NUM_PAR );
+		const uint8 offset_vh = display_obj_bg( xpos, ypos, is_global, true, visible, true CLIP_NUM_PAR );
 		if (visible) {
 			// display our vehicles
 			const uint8 offset_fg = display_obj_vh( xpos, ypos, offset_vh, ribi, true CLIP_NUM_PAR );
@@ -1633,7 +1633,7 @@ void grund_t::display_obj_all(const sint16 xpos, const sint16 ypos, const sint16
 		activate_ribi_clip( ribi | 16 CLIP_NUM_PAR );
 	}
 	// get offset of first vehicle
-	const uint8 offset_vh = display_obj_bg( xpos, ypos, is_global, false, visible CLIP_NUM_PAR );
+	const uint8 offset_vh = display_obj_bg( xpos, ypos, is_global, false, visible, true CLIP_NUM_PAR );
 	if(  !visible  ) {
 		// end of clipping
 		clear_all_poly_clip( CLIP_NUM_VAR );
@@ -1674,7 +1674,7 @@ void grund_t::display_obj_all(const sint16 xpos, const sint16 ypos, const sint16
 		if(  get_neighbour( gr, invalid_wt, ribi_t::east )  ) {
 			const bool draw_other_ways = (flags&draw_as_obj)  ||  (gr->flags&draw_as_obj)  ||  !gr->ist_karten_boden();
 			activate_ribi_clip( ribi_t::east|16 CLIP_NUM_PAR );
-			gr->display_obj_bg( xpos + raster_tile_width / 2, ypos + raster_tile_width / 4 - tile_raster_scale_y( (gr->get_hoehe() - pos.z) * TILE_HEIGHT_STEP, raster_tile_width ), is_global, draw_other_ways, true CLIP_NUM_PAR );
+			gr->display_obj_bg( xpos + raster_tile_width / 2, ypos + raster_tile_width / 4 - tile_raster_scale_y( (gr->get_hoehe() - pos.z) * TILE_HEIGHT_STEP, raster_tile_width ), is_global, draw_other_ways, true, false CLIP_NUM_PAR );
 		}
 	}
 	if(  ribi & ribi_t::south  ) {
@@ -1682,7 +1682,7 @@ void grund_t::display_obj_all(const sint16 xpos, const sint16 ypos, const sint16
 		if(  get_neighbour( gr, invalid_wt, ribi_t::south )  ) {
 			const bool draw_other_ways = (flags&draw_as_obj)  ||  (gr->flags&draw_as_obj)  ||  !gr->ist_karten_boden();
 			activate_ribi_clip( ribi_t::south|16 CLIP_NUM_PAR );
-			gr->display_obj_bg( xpos - raster_tile_width / 2, ypos + raster_tile_width / 4 - tile_raster_scale_y( (gr->get_hoehe() - pos.z) * TILE_HEIGHT_STEP, raster_tile_width ), is_global, draw_other_ways, true CLIP_NUM_PAR );
+			gr->display_obj_bg( xpos - raster_tile_width / 2, ypos + raster_tile_width / 4 - tile_raster_scale_y( (gr->get_hoehe() - pos.z) * TILE_HEIGHT_STEP, raster_tile_width ), is_global, draw_other_ways, true, false CLIP_NUM_PAR );
 		}
 	}
 	// display our vehicles
@@ -1740,7 +1740,7 @@ void grund_t::display_obj_all(const sint16 xpos, const sint16 ypos, const sint16
 }
 
 
-uint8 grund_t::display_obj_bg(const sint16 xpos, const sint16 ypos, const bool is_global, const bool draw_ways, const bool visible CLIP_NUM_DEF ) const
+uint8 grund_t::display_obj_bg(const sint16 xpos, const sint16 ypos, const bool is_global, const bool draw_ways, const bool visible, const bool own_tile CLIP_NUM_DEF ) const
 {
 	const bool dirty = get_flag(grund_t::dirty);
 
@@ -1763,7 +1763,8 @@ uint8 grund_t::display_obj_bg(const sint16 xpos, const sint16 ypos, const bool i
 		}
 		// display background images of everything but vehicles
 		const uint8 start_offset = draw_ways ? 0 : offsets[flags/has_way1];
-		return objlist.display_obj_bg( xpos, ypos, start_offset CLIP_NUM_PAR );
+		// dirty tiles (e.g. hidden by the cursor) are drawn without the cached images
+		return objlist.display_obj_bg( xpos, ypos, start_offset, own_tile  &&  is_global  &&  !dirty CLIP_NUM_PAR );
 	}
 	else { // must be karten_boden
 		// in undergroundmode: draw ground grid
@@ -2017,6 +2018,7 @@ sint64 grund_t::remove_trees()
 sint64 grund_t::neuen_weg_bauen(weg_t *weg, ribi_t::ribi ribi, player_t *player, koord3d_vector_t *route)
 {
 	sint64 cost=0;
+	way_builder_t::map_changed();
 
 	// not already there?
 	const weg_t * alter_weg = get_weg(weg->get_waytype());
@@ -2150,6 +2152,7 @@ sint32 grund_t::weg_entfernen(waytype_t wegtyp, bool ribi_rem)
 {
 	weg_t *weg = get_weg(wegtyp);
 	if(weg!=NULL) {
+		way_builder_t::map_changed();
 
 		weg->mark_image_dirty(get_image(), 0);
 
@@ -309,6 +309,9 @@ public:
 	 */
 	void set_all_obj_dirty() { objlist.set_all_dirty(); }
 
+	void invalidate_draw_list() const { objlist.invalidate_draw_list(); }
+	void free_draw_list() { objlist.free_draw_list(); }
+
 	/**
 	 * Dient zur Neuberechnung des Bildes, wenn sich die Umgebung
 	 * oder die Lage (Hang) des grundes geaendert hat.
@@ -577,7 +580,7 @@ public:
 	 * @param visible if false then draw only grids and markers
 	 * @return index of first vehicle on the tile
 	 */
-	uint8 display_obj_bg(const sint16 xpos, const sint16 ypos, const bool is_global, const bool draw_ways, const bool visible  CLIP_NUM_DEF) const;
+	uint8 display_obj_bg(const sint16 xpos, const sint16 ypos, const bool is_global, const bool draw_ways, const bool visible, const bool own_tile  CLIP_NUM_DEF) const;
 
 	/**
 	 * displays vehicle (background) images
@@ -142,6 +142,8 @@ bool schiene_t::unreserve(convoihandle_t c)
 		if(schiene_t::show_reservations) {
 			set_flag( obj_t::dirty );
 		}
+		// wake the trains waiting for this tile (in the next step of c)
+		c->release_reservation_waiters( get_pos() );
 		return true;
 	}
 	return false;
@@ -161,10 +163,13 @@ bool schiene_t::unreserve(vehicle_t*)
 		return true;
 	}
 //	if(!welt->lookup(get_pos())->suche_obj(v->get_typ())) {
+		const convoihandle_t c = reserved;
 		reserved = convoihandle_t();
 		if(schiene_t::show_reservations) {
 			set_flag( obj_t::dirty );
 		}
+		// wake the trains waiting for this tile (in the next step of c)
+		c->release_reservation_waiters( get_pos() );
 		return true;
 //	}
 //	return false;
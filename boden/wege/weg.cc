@@ -62,6 +62,8 @@ pthread_mutex_t weg_t::private_car_route_map::route_map_mtx = PTHREAD_MUTEX_INIT
  */
 vector_tpl <weg_t *> alle_wege;
 
+uint16 weg_t::statistics_epoch = 0;
+
 static slist_tpl<std::tuple<weg_t*, uint32, uint32>> pending_road_travel_time_updates;
 /**
  * Get list of all ways
@@ -430,16 +432,8 @@ void weg_t::calc_speed_limit(grund_t* gr, bool from_saved, const bruecke_t* brid
  */
 void weg_t::init_statistics()
 {
-	for(  int type=0;  type<MAX_WAY_STATISTICS;  type++  ) {
-		for(  int month=0;  month<MAX_WAY_STAT_MONTHS;  month++  ) {
-			statistics[month][type] = 0;
-		}
-	}
-	for(  int type=0;  type<MAX_WAY_TRAVEL_TIMES;  type++  ) {
-		for(  int month=0;  month<MAX_WAY_STAT_MONTHS;  month++  ) {
-			travel_times[month][type] = 0;
-		}
-	}
+	statistics.clear( statistics_epoch );
+	travel_times.clear( statistics_epoch );
 	creation_month_year = welt->get_timeline_year_month();
 }
 
@@ -544,9 +538,9 @@ void weg_t::rdwr(loadsave_t *file)
 	{
 		for(uint32 month = 0; month < MAX_WAY_STAT_MONTHS; month++)
 		{
-			sint32 w = statistics[month][type];
+			sint32 w = statistics.get( month, type, statistics_epoch );
 			file->rdwr_long(w);
-			statistics[month][type] = (sint16)w;
+			statistics.set( month, type, (sint16)w, statistics_epoch );
 		}
 	}
 
@@ -554,13 +548,7 @@ void weg_t::rdwr(loadsave_t *file)
 	if (file->is_loading() && ((file->get_extended_version() < 14) || (file->get_extended_version() == 14 && file->get_extended_revision() < 19)))
 	{
 		// Very early version - initialise the travel time statistics
-		for(uint32 type = 0; type < MAX_WAY_TRAVEL_TIMES; type++)
-		{
-			for (uint32 month = 0; month < MAX_WAY_STAT_MONTHS; month++)
-			{
-				travel_times[month][type] = 0;
-			}
-		}
+		travel_times.clear( statistics_epoch );
 	}
 
 	// NOTE: Revision 24 refers to the travel-time-congestion patch - if other patches that increment this number are merged first, then this must be updated too.
@@ -572,15 +560,16 @@ void weg_t::rdwr(loadsave_t *file)
 
 		for (uint32 month = 0; month < MAX_WAY_STAT_MONTHS; month++)
 		{
-			uint32 w = travel_times[month][WAY_TRAVEL_TIME_ACTUAL];
+			uint32 w = travel_times.get( month, WAY_TRAVEL_TIME_ACTUAL, statistics_epoch );
 
 			// Get the now-deprecated stopped vehicles count
 			file->rdwr_long(w);
 
-			travel_times[month][WAY_TRAVEL_TIME_IDEAL] = statistics[month][WAY_STAT_CONVOIS] * mul;
+			const uint32 convois = statistics.get( month, WAY_STAT_CONVOIS, statistics_epoch );
+			travel_times.set( month, WAY_TRAVEL_TIME_IDEAL, convois * mul, statistics_epoch );
 
 			// We'll estimate a stopped vehicle to take twice longer than usual to cross the tile
-			travel_times[month][WAY_TRAVEL_TIME_ACTUAL] = (statistics[month][WAY_STAT_CONVOIS] + (uint32)w) * mul;
+			travel_times.set( month, WAY_TRAVEL_TIME_ACTUAL, (convois + (uint32)w) * mul, statistics_epoch );
 		}
 	}
 
@@ -591,9 +580,9 @@ void weg_t::rdwr(loadsave_t *file)
 		{
 			for (uint32 month = 0; month < MAX_WAY_STAT_MONTHS; month++)
 			{
-				uint32 w = travel_times[month][type];
+				uint32 w = travel_times.get( month, type, statistics_epoch );
 				file->rdwr_long(w);
-				travel_times[month][type] = (uint32)w;
+				travel_times.set( month, type, w, statistics_epoch );
 			}
 		}
 	}
@@ -1238,19 +1227,6 @@ void weg_t::check_diagonal()
  */
 void weg_t::new_month()
 {
-	for (int type=0; type<MAX_WAY_STATISTICS; type++) {
-		for (int month=MAX_WAY_STAT_MONTHS-1; month>0; month--) {
-			statistics[month][type] = statistics[month-1][type];
-		}
-		statistics[0][type] = 0;
-	}
-
-	for (int type=0; type<MAX_WAY_TRAVEL_TIMES; type++) {
-		for (int month=MAX_WAY_STAT_MONTHS-1; month>0; month--) {
-			travel_times[month][type] = travel_times[month-1][type];
-		}
-		travel_times[0][type] = 0;
-	}
 	wear_way(desc->get_monthly_base_wear());
 }
 
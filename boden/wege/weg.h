@@ -19,6 +19,7 @@
 #include "../../dataobj/koord3d.h"
 #include "../../tpl/minivec_tpl.h"
 #include "../../tpl/ordered_vector_tpl.h"
+#include "../../tpl/ring_history_tpl.h"
 #include "../../simskin.h"
 
 #ifdef MULTI_THREAD
@@ -125,13 +126,19 @@ public:
 
 private:
 	/**
-	* array for statistical values
+	* statistical values
 	* MAX_WAY_STAT_MONTHS: [0] = actual value; [1] = last month value
 	* MAX_WAY_STATISTICS: see #define at top of file
+	* Both histories are indexed by statistics_epoch, so a new month costs nothing per way.
 	*/
-	sint16 statistics[MAX_WAY_STAT_MONTHS][MAX_WAY_STATISTICS];
+	ring_history_tpl<sint16, MAX_WAY_STAT_MONTHS, MAX_WAY_STATISTICS> statistics;
 
-	uint32 travel_times[MAX_WAY_STAT_MONTHS][MAX_WAY_TRAVEL_TIMES];
+	ring_history_tpl<uint32, MAX_WAY_STAT_MONTHS, MAX_WAY_TRAVEL_TIMES> travel_times;
+
+	/// month counter of all way statistics, incremented by new_statistics_month()
+	static uint16 statistics_epoch;
+
+	inline uint32 get_travel_time(way_stat_months month, int type) const { return travel_times.get( month, type, statistics_epoch ); }
 
 
 	/**
@@ -491,17 +498,22 @@ public:
 	/**
 	* book statistics - is called very often and therefore inline
 	*/
-	void book(int amount, way_statistics type) { statistics[WAY_STAT_THIS_MONTH][type] += amount; }
+	void book(int amount, way_statistics type) { statistics.book( type, amount, statistics_epoch ); }
 
 	/**
 	 * return statistics value
 	 */
-	int get_statistics(way_stat_months month, way_statistics type) const { return statistics[(int)month][(int)type]; }
+	int get_statistics(way_stat_months month, way_statistics type) const { return statistics.get( month, type, statistics_epoch ); }
+
+	bool is_disused() const { return get_statistics(WAY_STAT_LAST_MONTH, WAY_STAT_CONVOIS) == 0 && get_statistics(WAY_STAT_THIS_MONTH, WAY_STAT_CONVOIS) == 0; }
 
-	bool is_disused() const { return statistics[WAY_STAT_LAST_MONTH][WAY_STAT_CONVOIS] == 0 && statistics[WAY_STAT_THIS_MONTH][WAY_STAT_CONVOIS] == 0; }
+	/**
+	 * Starts a new month for the statistics of all ways (without touching them)
+	 */
+	static void new_statistics_month() { statistics_epoch++; }
 
 	/**
-	* new month
+	* new month: monthly wear, called for each way spread over the steps after the month change
 	*/
 	void new_month();
 
@@ -581,17 +593,17 @@ public:
 	//void increment_traffic_stopped_counter() { statistics[0][WAY_STAT_WAITING] ++; }
 	inline void update_travel_times(uint32 actual, uint32 ideal)
 	{
-		travel_times[WAY_STAT_THIS_MONTH][WAY_TRAVEL_TIME_ACTUAL] += actual;
-		travel_times[WAY_STAT_THIS_MONTH][WAY_TRAVEL_TIME_IDEAL] += ideal;
+		travel_times.book( WAY_TRAVEL_TIME_ACTUAL, actual, statistics_epoch );
+		travel_times.book( WAY_TRAVEL_TIME_IDEAL, ideal, statistics_epoch );
 	}
 
 	//will return the % ratio of actual to ideal traversal times
 	inline uint32 get_congestion_percentage() const {
-		uint32 combined_ideal = travel_times[WAY_STAT_THIS_MONTH][WAY_TRAVEL_TIME_IDEAL] + travel_times[WAY_STAT_LAST_MONTH][WAY_TRAVEL_TIME_IDEAL];
+		uint32 combined_ideal = get_travel_time(WAY_STAT_THIS_MONTH, WAY_TRAVEL_TIME_IDEAL) + get_travel_time(WAY_STAT_LAST_MONTH, WAY_TRAVEL_TIME_IDEAL);
 		if(combined_ideal == 0u) {
 			return 0u;
 		}
-		uint32 combined_actual = travel_times[WAY_STAT_THIS_MONTH][WAY_TRAVEL_TIME_ACTUAL] + travel_times[WAY_STAT_LAST_MONTH][WAY_TRAVEL_TIME_ACTUAL];
+		uint32 combined_actual = get_travel_time(WAY_STAT_THIS_MONTH, WAY_TRAVEL_TIME_ACTUAL) + get_travel_time(WAY_STAT_LAST_MONTH, WAY_TRAVEL_TIME_ACTUAL);
 		if(combined_actual <= combined_ideal) {
 			return 0u;
 		}
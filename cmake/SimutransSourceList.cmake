@@ -86,6 +86,7 @@ target_sources(simutrans-extended PRIVATE
 	descriptor/tunnel_desc.cc
 	descriptor/vehicle_desc.cc
 	descriptor/way_desc.cc
+	display/blitter.cc
 	display/font.cc
 	display/simview.cc
 	display/viewport.cc
@@ -222,6 +223,7 @@ target_sources(simutrans-extended PRIVATE
 	gui/sound_frame.cc
 	gui/sprachen.cc
 	gui/station_building_select.cc
+	gui/step_profiler_frame.cc
 	gui/themeselector.cc
 	gui/times_history_container.cc
 	gui/tool_selector.cc
@@ -244,6 +246,7 @@ target_sources(simutrans-extended PRIVATE
 	io/rdwr/zlib_file_rdwr_stream.cc
 	io/classify_file.cc
 	network/checksum.cc
+	network/command_journal.cc
 	network/memory_rw.cc
 	network/network_address.cc
 	network/network.cc
@@ -310,6 +313,7 @@ target_sources(simutrans-extended PRIVATE
 	script/export_objs.cc
 	script/script.cc
 	script/script_loader.cc
+	simbenchmark.cc
 	simcity.cc
 	simconvoi.cc
 	simdebug.cc
@@ -369,6 +373,7 @@ target_sources(simutrans-extended PRIVATE
 	utils/simrandom.cc
 	utils/simstring.cc
 	utils/simthread.cc
+	utils/step_profiler.cc
 	vehicle/movingobj.cc
 	vehicle/pedestrian.cc
 	vehicle/simroadtraffic.cc
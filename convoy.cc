@@ -19,9 +19,6 @@ static karte_ptr_t welt;
 static const float32e8_t g_accel((uint32) 980665, (uint32) 100000); // gravitational acceleration
 
 static const float32e8_t _101_percent((uint32) 101, (uint32) 100);
-static const float32e8_t _110_percent((uint32) 110, (uint32) 100);
-
-static const float32e8_t million((uint32) 1000000);
 
 const float32e8_t BR_AIR = float32e8_t(2, 1);
 const float32e8_t BR_WATER = float32e8_t(1, 10);
@@ -31,6 +28,75 @@ const float32e8_t BR_MAGLEV = float32e8_t(12, 10);
 const float32e8_t BR_ROAD = float32e8_t(4, 1);
 const float32e8_t BR_DEFAULT = float32e8_t(1, 1);
 
+/*
+ * Fixed point arithmetic of calc_move() and calc_min_braking_distance(), which run every
+ * sync step for every moving convoy. All values are sint64:
+ * speeds in 1/65536 m/s, distances in 1/65536 m, times in 1/65536 s,
+ * accelerations in 1/65536 m/s^2 and forces in 1/256 N.
+ * Integer arithmetic gives the same results on all platforms, as network games require.
+ * (Right shifts of negative values are arithmetic on all supported compilers.)
+ */
+#define FX_SHIFT (16)
+#define FX_ONE ((sint64)1 << FX_SHIFT)
+#define FX_FORCE_SHIFT (8)
+
+// speed conversions: simspeed2ms = 50/2304, kmh2ms = 10/36
+#define FX_SPEED_TO_V(speed) ((sint64)(speed) * 12800 / 9)
+#define FX_KMH_TO_V(kmh) ((sint64)(kmh) * 163840 / 9)
+// v_to_speed(): trunc(v * 2304/50 + 1/2)
+#define FX_V_TO_SPEED(v) ((sint32)(((v) * 9 + 6400) / 12800))
+#define FX_V_MIN FX_KMH_TO_V(KMH_MIN)
+
+// g_accel = 9.80665 m/s^2, applied to a mass in 1/256 kg
+#define FX_G_FORCE(kg) ((kg) * 980665 / 100000)
+
+static inline sint64 fx_mul(const sint64 a, const sint64 b)
+{
+	return (a * b) >> FX_SHIFT;
+}
+
+static inline sint64 fx_abs(const sint64 a)
+{
+	return a < 0 ? -a : a;
+}
+
+static uint64 fx_isqrt(uint64 x)
+{
+	uint64 root = 0;
+	uint64 bit = (uint64)1 << 62;
+	while (bit > x)
+	{
+		bit >>= 2;
+	}
+	while (bit)
+	{
+		if (x >= root + bit)
+		{
+			x -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return root;
+}
+
+// air resistance cf * v^2 in 1/256 N with cf in 1/65536 N/(m/s)^2
+static inline sint64 fx_air_resistance(const sint64 cf, const sint64 v)
+{
+	return (cf * ((v * v) >> 20)) >> 20;
+}
+
+// Frs = g * (fr * weight_cos + weight_sin) in 1/256 N
+static inline sint64 fx_rolling_slope_resistance(const float32e8_t &fr, const weight_summary_t &weight)
+{
+	const sint64 kg = ((fr.to_fixed(24) * weight.weight_cos.to_fixed(0)) >> 16) + weight.weight_sin.to_fixed(0) * 256;
+	return FX_G_FORCE(kg);
+}
+
 // helps to calculate roots. pow fails to calculate roots of negative bases.
 inline const float32e8_t signed_power(const float32e8_t &base, const float32e8_t &expo)
 {
@@ -266,7 +332,6 @@ sint32 convoy_t::calc_max_starting_weight(sint32 sin_alpha)
 #define DT_SLICE (DT_TIME_FACTOR * DT_SLICE_SECONDS)
 //static const float32e8_t fl_time_factor(DT_TIME_FACTOR, 1);
 //static const float32e8_t fl_time_divisor(1, DT_TIME_FACTOR);
-static const float32e8_t fl_slice_seconds(DT_SLICE_SECONDS);
 static const float32e8_t fl_max_seconds_til_vsoll(1800);
 
 float32e8_t convoy_t::calc_min_braking_distance(const weight_summary_t &weight, const float32e8_t &v)
@@ -288,8 +353,17 @@ float32e8_t convoy_t::calc_min_braking_distance(const weight_summary_t &weight,
 
 sint32 convoy_t::calc_min_braking_distance(const settings_t &settings, const weight_summary_t &weight, sint32 speed)
 {
-	const float32e8_t x = calc_min_braking_distance(weight, speed_to_v(speed)) * _110_percent;
-	return settings.meters_to_steps(x).to_sint32();
+	// The same estimation as above (plus 10%) in fixed point: x = 1/2 v^2 m / (F + Frs)
+	const sint64 F = get_braking_force(/*v*/).to_fixed(FX_FORCE_SHIFT) + fx_rolling_slope_resistance(adverse.fr, weight);
+	if (F == 0 || weight.weight <= 0)
+	{
+		return 0;
+	}
+	const sint64 v = FX_SPEED_TO_V(speed) >> 8; // in 1/256 m/s
+	const sint64 vv = v * v;
+	// in 1/256 m; divide first only for extreme weights and speeds, which would overflow
+	const sint64 x = vv < SINT64_MAX_VALUE / weight.weight ? (weight.weight * vv) / (2 * F) : weight.weight * (vv / (2 * F));
+	return (sint32)(x * 11 / (10 * (sint64)settings.get_meters_per_tile())); // 256 steps per tile
 }
 
 
@@ -324,9 +398,41 @@ uint32 convoy_t::calc_acceleration_distance(const weight_summary_t &weight, sint
 	return travel_distance/100; // in meter
 }
 
-inline float32e8_t _calc_move(const float32e8_t &a, const float32e8_t &t, const float32e8_t &v0)
+static inline sint64 fx_calc_move(const sint64 a, const sint64 t, const sint64 v0)
+{
+	return fx_mul(fx_mul(a, t) / 2 + v0, t);
+}
+
+
+sint64 convoy_t::get_force_fixed(const settings_t &settings, sint64 v)
+{
+	const sint32 factor = settings.get_global_force_factor_percent();
+	if (force_table_factor != factor)
+	{
+		// the convoy never runs faster than its slowest vehicle
+		force_table.clear();
+		const sint32 max_speed = get_vehicle_summary().max_speed;
+		if (max_speed < KMH_SPEED_UNLIMITED)
+		{
+			const sint32 max_v = (max_speed * 10 + 35) / 36 + 1;
+			force_table.resize(max_v + 1);
+			for (sint32 i = 0; i <= max_v; i++)
+			{
+				force_table.append(get_force_summary(i).to_fixed(FX_FORCE_SHIFT));
+			}
+		}
+		force_table_factor = factor;
+	}
+	const uint32 speed = (uint32)(fx_abs(v) >> FX_SHIFT);
+	return speed < force_table.get_count() ? force_table[speed] : get_force_summary(speed).to_fixed(FX_FORCE_SHIFT);
+}
+
+
+sint64 convoy_t::calc_speed_holding_force_fixed(const settings_t &settings, sint64 v, sint64 cf, sint64 Frs)
 {
-	return (float32e8_t::half * a * t + v0) * t;
+	const sint64 f = get_force_fixed(settings, v);
+	const sint64 hold = fx_air_resistance(cf, v) + Frs;
+	return f < hold ? f : hold;
 }
 
 void convoy_t::calc_move(const settings_t &settings, long delta_t, const weight_summary_t &weight, sint32 akt_speed_soll, sint32 next_speed_limit, sint32 steps_til_limit, sint32 steps_til_brake, sint32 &akt_speed, sint32 &sp_soll, float32e8_t &akt_v)
@@ -342,40 +448,46 @@ void convoy_t::calc_move(const settings_t &settings, long delta_t, const weight_
 	}
 	else
 	{
-		const float32e8_t fweight = weight.weight; // convoy's weight in kg
-		const float32e8_t Frs = g_accel * (get_adverse_summary().fr * weight.weight_cos + weight.weight_sin); // Frs in N, weight.weight_cos and weight.weight_sin are calculated per vehicle due to vehicle specific slope angle.
-		const float32e8_t vlim = speed_to_v(next_speed_limit); // vlim in m/s, next_speed_limit in simutrans vehicle speed.
-		const float32e8_t xlim = settings.steps_to_meters(steps_til_limit); // xbrk in m, steps_til_limit in simutrans steps
-		const float32e8_t xbrk = settings.steps_to_meters(steps_til_brake); // xbrk in m, steps_til_brake in simutrans steps
-		//float32e8_t vsoll = min(speed_to_v(akt_speed_soll), kmh2ms * min(adverse.max_speed, get_vehicle_summary().max_speed)); // vsoll in m/s, akt_speed_soll in simutrans vehicle speed. "Soll" translates to "Should", so this is the speed limit.
-		const float32e8_t check_vsoll_1 = speed_to_v(akt_speed_soll);
-		const float32e8_t check_vsoll_2 = kmh2ms * min(adverse.max_speed, get_vehicle_summary().max_speed);
-		float32e8_t vsoll = check_vsoll_1 < check_vsoll_2 ? check_vsoll_1 : check_vsoll_2;
-		float32e8_t fvsoll = float32e8_t::zero; // force in N needed to hold vsoll. calculated when needed.
-		float32e8_t speed_ratio = float32e8_t::zero; // requested speed / convoy's max speed. calculated when needed.
-		float32e8_t dx = float32e8_t::zero; // covered distance in m
-		float32e8_t v = akt_v; // v and akt_v in m/s
-		float32e8_t bf = float32e8_t::zero; // braking force in N
+		const sint64 mpt = settings.get_meters_per_tile();
+		sint64 delta_fx = (sint64)delta_t * mpt * 72 / 25; // delta_t ticks in 1/65536 s: seconds_per_tick = meters_per_tile * 9 / 204800
+		const sint32 fweight = weight.weight > 0 ? weight.weight : 1; // convoy's weight in kg
+		const sint64 Frs = fx_rolling_slope_resistance(get_adverse_summary().fr, weight); // weight.weight_cos and weight.weight_sin are calculated per vehicle due to vehicle specific slope angle.
+		const sint64 cf = adverse.cf.to_fixed(FX_SHIFT);
+		const sint64 vlim = FX_SPEED_TO_V(next_speed_limit);
+		const sint64 xlim = (sint64)steps_til_limit * mpt * 256; // 256 steps per tile
+		const sint64 xbrk = (sint64)steps_til_brake * mpt * 256;
+		// "Soll" translates to "Should", so this is the speed limit.
+		const sint64 check_vsoll_1 = FX_SPEED_TO_V(akt_speed_soll);
+		const sint64 check_vsoll_2 = FX_KMH_TO_V(min(adverse.max_speed, get_vehicle_summary().max_speed));
+		sint64 vsoll = check_vsoll_1 < check_vsoll_2 ? check_vsoll_1 : check_vsoll_2;
+		sint64 fvsoll = 0; // force needed to hold vsoll. calculated when needed.
+		bool fvsoll_valid = false;
+		sint64 dx = 0; // covered distance
+		sint64 v = akt_v.to_fixed(FX_SHIFT);
+		sint64 bf = 0; // braking force
+		bool bf_valid = false;
 		// iterate the passed time.
-		while (delta_s > float32e8_t::zero)
+		while (delta_fx > 0)
 		{
 			// 1) The driver's part: select the force:
-			bool is_braking = v >= _110_percent * vsoll;
+			bool is_braking = v * 10 >= vsoll * 11;
 			if (dx >= xbrk)
 			{
 				vsoll = vlim;
 				is_braking = true;
 			}
 
-			float32e8_t f;
+			sint64 f;
 			if (is_braking)
 			{
 				// running too fast, slam on the brakes!
 				// hill-down Frs might become negative and works against the brake.
 				// hill-up Frs helps braking, but don't brake too hard (with respect to health of passengers and freight)
-				if (bf == float32e8_t::zero) // bf is a constant within this function. So calculate it once only.
+				if (!bf_valid) // bf is a constant within this function. So calculate it once only.
 				{
-					bf = -get_braking_force(/*v*/) + fl_max(float32e8_t::zero, g_accel * weight.weight_sin);
+					const sint64 hill = FX_G_FORCE(weight.weight_sin.to_fixed(0) * 256);
+					bf = -get_braking_force(/*v*/).to_fixed(FX_FORCE_SHIFT) + (hill > 0 ? hill : 0);
+					bf_valid = true;
 				}
 				f = bf;
 			}
@@ -384,71 +496,70 @@ void convoy_t::calc_move(const settings_t &settings, long delta_t, const weight_
 				// Below set speed: full acceleration
 				// If set speed is far below the convoy max speed as e.g. aircrafts on ground reduce force.
 				// If set speed is at most a 10th of convoy's maximum, we reduce force to its 10th.
-				f = get_force(v);
-				if (f > million) // reducing force does not apply to 'weak' convoy's, thus we can save a lot of time skipping this code.
+				f = get_force_fixed(settings, v);
+				if (f > ((sint64)1000000 << FX_FORCE_SHIFT)) // reducing force does not apply to 'weak' convoy's, thus we can save a lot of time skipping this code.
 				{
-					if (speed_ratio == float32e8_t::zero) // speed_ratio is a constant within this function. So calculate it once only.
-					{
-						speed_ratio = ms2kmh * vsoll / vehicle_summary.max_speed;
-					}
-					if (speed_ratio < float32e8_t::tenth)
+					// requested speed / convoy's max speed < 1/10, i.e. 3.6 * vsoll * 10 < max_speed
+					if (vsoll * 36 < (sint64)vehicle_summary.max_speed * FX_ONE)
 					{
-						if (fvsoll == float32e8_t::zero) // fvsoll is a constant within this function. So calculate it once only.
+						if (!fvsoll_valid) // fvsoll is a constant within this function. So calculate it once only.
 						{
-							fvsoll = calc_speed_holding_force(vsoll, Frs);
+							fvsoll = calc_speed_holding_force_fixed(settings, vsoll, cf, Frs);
+							fvsoll_valid = true;
 						}
 						if (f > fvsoll)
 						{
-							f = (f - fvsoll) * float32e8_t::tenth + fvsoll;
+							f = (f - fvsoll) / 10 + fvsoll;
 						}
 					}
 				}
 			}
 			else
 			{
-				if (fvsoll == float32e8_t::zero) // fvsoll is a constant within this function. So calculate it once only.
+				if (!fvsoll_valid) // fvsoll is a constant within this function. So calculate it once only.
 				{
-					fvsoll = calc_speed_holding_force(vsoll, Frs);
+					fvsoll = calc_speed_holding_force_fixed(settings, vsoll, cf, Frs);
+					fvsoll_valid = true;
 				}
 				f = fvsoll;
 			}
-			const float32e8_t Ff = sgn(v) * adverse.cf * v * v;
-			f -= Ff + Frs;
+			const sint64 Ff = fx_air_resistance(cf, v);
+			f -= (v < 0 ? -Ff : Ff) + Frs;
 
 			// 2) The "differential equation" part: calculate new speed:
-			float32e8_t dt_s;
-			if (delta_s >= fl_slice_seconds && abs(f.to_sint32()) > weight.weight / (10 * DT_SLICE_SECONDS))
+			sint64 dt;
+			if (delta_fx >= DT_SLICE_SECONDS * FX_ONE && fx_abs(f / (1 << FX_FORCE_SHIFT)) > fweight / (10 * DT_SLICE_SECONDS))
 			{
 				// This part is important for acceleration/deceleration phases only.
 				// If the force to weight ratio exceeds a certain level, then we must calculate speed iterative,
 				// as it depends on previous speed.
-				dt_s = fl_slice_seconds;
+				dt = DT_SLICE_SECONDS * FX_ONE;
 			}
 			else
 			{
 				// If a small force produces a small speed change, we can add the difference at once in the 'else' section
 				// with a disregardable inaccuracy.
-				dt_s = delta_s;
+				dt = delta_fx;
 			}
-			float32e8_t a = f / fweight;
-			float32e8_t v0 = v;
-			float32e8_t x;
-			v += a * dt_s;
+			sint64 a = f * (1 << (FX_SHIFT - FX_FORCE_SHIFT)) / fweight;
+			const sint64 v0 = v;
+			sint64 x;
+			v += fx_mul(a, dt);
 			if (is_braking)
 			{
 				if (v < vsoll)
 				{
 					// don't brake too much
 					v = vsoll;
-					a = v / dt_s;
+					a = v * FX_ONE / dt;
 				}
-				x = dx + _calc_move(a, dt_s, v0);
-				if (x > xlim && v < V_MIN)
+				x = dx + fx_calc_move(a, dt, v0);
+				if (x > xlim && v < FX_V_MIN)
 				{
 					// don't stop before arrival.
-					v = V_MIN;
-					a = v / dt_s;
-					x = dx + _calc_move(a, dt_s, v0);
+					v = FX_V_MIN;
+					a = v * FX_ONE / dt;
+					x = dx + fx_calc_move(a, dt, v0);
 				}
 			}
 			else
@@ -458,35 +569,33 @@ void convoy_t::calc_move(const settings_t &settings, long delta_t, const weight_
 					// don't accelerate too much
 					v = vsoll;
 				}
-				else if (v < V_MIN)
+				else if (v < FX_V_MIN)
 				{
-					v = V_MIN;
+					v = FX_V_MIN;
 				}
-				x = dx + _calc_move(a, dt_s, v0);
+				x = dx + fx_calc_move(a, dt, v0);
 				if (x > xbrk)
 				{
 					// don't run beyond xbrk, where we must start braking.
 					x = xbrk;
-					if (xbrk > dx && abs(a) > float32e8_t::milli)
+					if (xbrk > dx && fx_abs(a) > FX_ONE / 1000)
 					{
 						// turn back time to when we reached xbrk:
-						dt_s = (sqrt(v0 * v0 + float32e8_t::two * a * (xbrk - dx)) - v0) / a;
+						const sint64 vv = v0 * v0 + 2 * a * (xbrk - dx);
+						dt = ((sint64)fx_isqrt(vv > 0 ? (uint64)vv : 0) - v0) * FX_ONE / a;
+						if (dt < 0)
+						{
+							dt = 0;
+						}
 					}
 				}
 			}
 			dx = x;
-			if (delta_s == dt_s) {
-				// Fix strange bug (macOS, clang LLVM v9.0.0): when compiled without -fno-inline (DEBUG <= 1),
-				// and when delta_s == dt_s, delta_s - dt_s equals some positive number instead of zero, which
-				// causes the while loop & this function to run forever.
-				delta_s = float32e8_t::zero;
-			} else {
-				delta_s -= dt_s; // another time slice passed
-			}
+			delta_fx -= dt; // another time slice passed
 		}
-		akt_v = v;
-		akt_speed = v_to_speed(v); // akt_speed in simutrans vehicle speed, v in m/s
-		sp_soll += (sint32)(settings.meters_to_steps(dx) * steps2yards); // sp_soll in simutrans yards, dx in m
+		akt_v = float32e8_t::from_fixed(v, FX_SHIFT);
+		akt_speed = FX_V_TO_SPEED(v); // akt_speed in simutrans vehicle speed
+		sp_soll += (sint32)(dx * 16 / mpt); // sp_soll in simutrans yards: 256 steps per tile, 4096 yards per step
 	}
 }
 
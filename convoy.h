@@ -219,6 +219,25 @@ private:
 		return get_force_summary(abs(speed));
 	}
 
+	/**
+	 * Engine force in 1/256 N for every speed in whole m/s up to the maximum speed,
+	 * the fixed point copy of get_force_summary() used by calc_move().
+	 * It is valid for the global force factor force_table_factor, 0 if invalid.
+	 */
+	vector_tpl<sint64> force_table;
+	sint32 force_table_factor;
+
+	/**
+	 * Get force in 1/256 N according to speed v in 1/65536 m/s
+	 */
+	sint64 get_force_fixed(const class settings_t &settings, sint64 v);
+
+	/**
+	 * calc_speed_holding_force() in fixed point: force in 1/256 N, v in 1/65536 m/s,
+	 * air resistance cf in 1/65536 N/(m/s)^2
+	 */
+	sint64 calc_speed_holding_force_fixed(const class settings_t &settings, sint64 v, sint64 cf, sint64 Frs);
+
 public:
 	/**
 	 * Get force in N that holds the given speed v or maximum available force, what ever is lesser.
@@ -234,6 +253,9 @@ protected:
 	vehicle_summary_t vehicle_summary;
 	adverse_summary_t adverse;
 
+	/// the force table must be recalculated, when the vehicles change
+	inline void invalidate_force_table() { force_table_factor = 0; }
+
 	/**
 	 * get brake force in kN according to current speed in m/s
 	 */
@@ -358,8 +380,11 @@ public:
 	 * @param steps_til_brake the distance in simutrans steps to the point where we must start braking to obey the speed limit at steps_til_limit.
 	 * @param akt_speed the current speed and returns the new speed after delta_t has gone in simutrans speed.
 	 * @param sp_soll the number of simutrans yards still to go and returns the new number of simutrans yards to go.
+	 * @param akt_v the current speed and returns the new speed in m/s. Internally the movement is calculated in fixed point.
 	 */
 	void calc_move(const class settings_t &settings, long delta_t, const weight_summary_t &weight, sint32 akt_speed_soll, sint32 next_speed_limit, sint32 steps_til_limit, sint32 steps_til_brake, sint32 &akt_speed, sint32 &sp_soll, float32e8_t &akt_v);
+
+	convoy_t() : force_table_factor(0) {}
 	virtual ~convoy_t(){}
 };
 
@@ -397,6 +422,7 @@ public:
 	inline void invalidate_vehicle_summary()
 	{
 		is_valid &= ~(cd_vehicle_summary|cd_adverse_summary|cd_weight_summary|cd_starting_force|cd_continuous_power|cd_braking_force);
+		invalidate_force_table();
 	}
 
 	// vehicle_summary is valid if (is_valid & cd_vehicle_summary != 0)
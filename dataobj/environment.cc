@@ -68,6 +68,8 @@ sint32 env_t::server_frames_ahead = 4;
 sint32 env_t::additional_client_frames_behind = 4;
 sint32 env_t::network_frames_per_step = 4;
 uint32 env_t::server_sync_steps_between_checks = 24;
+uint32 env_t::subsystem_hash_interval = 256;
+bool env_t::subsystem_hash_log = false;
 bool env_t::pause_server_no_clients = false;
 bool env_t::server_runs_background_tasks_when_paused = false;
 
@@ -163,6 +165,10 @@ bool env_t::cities_ignore_height = false;
 bool env_t::second_open_closes_win;
 bool env_t::remember_window_positions;
 uint8 env_t::num_threads;
+uint32 env_t::image_cache_mb;
+uint32 env_t::script_step_ops;
+uint32 env_t::script_step_ms;
+bool env_t::script_profile;
 bool env_t::draw_earth_border;
 bool env_t::draw_outside_tile;
 
@@ -303,6 +309,12 @@ void env_t::init()
 	num_threads = 1;
 #endif
 
+	image_cache_mb = 0;
+
+	script_step_ops = 0;
+	script_step_ms = 0;
+	script_profile = false;
+
 	sound_distance_scaling = 10;
 
 	show_tooltips = true;
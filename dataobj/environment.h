@@ -83,6 +83,15 @@ public:
 	/// @see karte_t::interactive()
 	static uint32 server_sync_steps_between_checks;
 
+	/// per-subsystem state hashes are added to the checklist every this many sync_steps (0 = off)
+	/// rounded up to a multiple of server_sync_steps_between_checks, since they are only compared at the checks
+	/// only the server's value counts, it is sent to the clients with the settings
+	/// @see karte_t::calc_subsystem_hashes()
+	static uint32 subsystem_hash_interval;
+
+	/// if true, every subsystem hash calculation also writes the per-object hashes to a log file
+	static bool subsystem_hash_log;
+
 	/// when true, restore the windows from a savegame
 	static bool restore_UI;
 
@@ -434,6 +443,18 @@ public:
 	/// number of threads to use (if MULTI_THREAD defined)
 	static uint8 num_threads;
 
+	/// memory for zoomed and recoloured copies of the images in MB (0 = no limit)
+	static uint32 image_cache_mb;
+
+	/// opcodes a script may run per step, later calls wait for the next step (0 = no limit)
+	static uint32 script_step_ops;
+
+	/// time in ms a script may run per step, later calls wait for the next step (0 = no limit)
+	static uint32 script_step_ms;
+
+	/// write calls, time and allocations of every script function to a csv file next to the script log
+	static bool script_profile;
+
 	/// false to quit the programs
 	static bool quit_simutrans;
 
@@ -66,48 +66,98 @@ static nodelist_node_t *all_lists[NUM_LIST] = {
 // to have this working, we need chunks at least the size of a pointer
 const size_t min_size = sizeof(void *);
 
+// statistics of all size classes, the last one counts the nodes too large for the lists
+static freelist_t::stats_t all_stats[NUM_LIST+1];
+static_assert( freelist_t::STATS_COUNT == NUM_LIST+1, "statistics size mismatch" );
 
-void *freelist_t::gimme_node(size_t size)
+// increased whenever all nodes are freed, to invalidate the magazines
+static uint32 freelist_epoch = 1;
+
+
+/* Each thread keeps a magazine of free nodes per size class, so most requests
+ * are served without taking the mutex. The magazines are refilled from and
+ * returned to the global lists in batches of MAGAZINE_BATCH nodes.
+ */
+#define MAGAZINE_BATCH (32)
+
+struct magazine_t
 {
-	nodelist_node_t ** list = NULL;
-	if(  size == 0  ) {
-		return NULL;
+	nodelist_node_t *list[NUM_LIST];
+	uint16 count[NUM_LIST];
+
+	// not yet added to all_stats
+	uint64 allocs[NUM_LIST+1];
+	uint64 frees[NUM_LIST+1];
+
+	uint32 epoch;
+
+	magazine_t()
+	{
+		clear();
+		for(  int i=0;  i<=NUM_LIST;  i++  ) {
+			allocs[i] = 0;
+			frees[i] = 0;
+		}
 	}
 
-	// all sizes should be dividable by 4 and at least as large as a pointer
-#ifdef DEBUG_FREELIST
-	size = max( min_size, size + min_size);
-#else
-	size = max( min_size, size );
-#endif
-	size = (size+3)>>2;
-	size <<= 2;
+	~magazine_t();
+
+	void clear()
+	{
+		for(  int i=0;  i<NUM_LIST;  i++  ) {
+			list[i] = NULL;
+			count[i] = 0;
+		}
+		epoch = freelist_epoch;
+	}
+};
 
 #ifdef MULTI_THREAD
-	int error = pthread_mutex_lock( &freelist_mutex );
-	assert(error == 0);
-	(void)error;
+static thread_local magazine_t magazine;
+#else
+static magazine_t magazine;
 #endif
 
-	// hold return value
-	nodelist_node_t *tmp;
-	if(  size > MAX_LIST_INDEX  ) {
-		// too large: just use malloc anyway
-		tmp = (nodelist_node_t *)xmalloc(size);
+
+static void lock_lists(int idx)
+{
 #ifdef MULTI_THREAD
-		error = pthread_mutex_unlock( &freelist_mutex );
+	if(  pthread_mutex_trylock( &freelist_mutex ) != 0  ) {
+		int error = pthread_mutex_lock( &freelist_mutex );
 		assert(error == 0);
+		(void)error;
+		all_stats[idx].contended ++;
+	}
+#else
+	(void)idx;
 #endif
-#ifdef DEBUG_FREELIST
-		tmp->magic = 0xAA;
-		tmp->free = 0;
-		tmp->size = size/4;
+}
+
+
+static void unlock_lists()
+{
+#ifdef MULTI_THREAD
+	int error = pthread_mutex_unlock( &freelist_mutex );
+	assert(error == 0);
+	(void)error;
 #endif
-		return tmp;
-	}
+}
+
+
+// adds the counts of the magazine to the statistics (list must be locked)
+static void book_magazine_stats(int idx)
+{
+	all_stats[idx].allocs += magazine.allocs[idx];
+	all_stats[idx].frees += magazine.frees[idx];
+	magazine.allocs[idx] = 0;
+	magazine.frees[idx] = 0;
+}
 
 
-	list = &(all_lists[size/4]);
+// moves up to MAGAZINE_BATCH nodes of a size into the magazine (list must be locked)
+static void refill_magazine(int idx, size_t size)
+{
+	nodelist_node_t **list = &(all_lists[idx]);
 	// need new memory?
 	if(  *list == NULL  ) {
 		int num_elements = 32764/(int)size;
@@ -143,11 +193,99 @@ void *freelist_t::gimme_node(size_t size)
 			tmp->next = *list;
 			*list = tmp;
 		}
+		all_stats[idx].chunks ++;
+	}
+
+	// take a batch from the front of the list
+	nodelist_node_t *first = *list, *last = *list;
+	uint16 n = 1;
+	while(  n < MAGAZINE_BATCH  &&  last->next  ) {
+		last = last->next;
+		n++;
+	}
+	*list = last->next;
+	last->next = magazine.list[idx];
+	magazine.list[idx] = first;
+	magazine.count[idx] += n;
+	all_stats[idx].refills ++;
+}
+
+
+// returns MAGAZINE_BATCH nodes of the magazine to the global list (list must be locked)
+static void flush_magazine(int idx, uint16 n)
+{
+	nodelist_node_t *first = magazine.list[idx], *last = first;
+	for(  uint16 i=1;  i<n;  i++  ) {
+		last = last->next;
+	}
+	magazine.list[idx] = last->next;
+	magazine.count[idx] -= n;
+	last->next = all_lists[idx];
+	all_lists[idx] = first;
+	all_stats[idx].returns ++;
+}
+
+
+magazine_t::~magazine_t()
+{
+	// the thread ends: give its nodes back
+	lock_lists(NUM_LIST);
+	for(  int i=0;  i<=NUM_LIST;  i++  ) {
+		if(  i < NUM_LIST  &&  count[i]  &&  epoch == freelist_epoch  ) {
+			flush_magazine(i, count[i]);
+		}
+		book_magazine_stats(i);
+	}
+	unlock_lists();
+}
+
+
+void *freelist_t::gimme_node(size_t size)
+{
+	if(  size == 0  ) {
+		return NULL;
+	}
+
+	// all sizes should be dividable by 4 and at least as large as a pointer
+#ifdef DEBUG_FREELIST
+	size = max( min_size, size + min_size);
+#else
+	size = max( min_size, size );
+#endif
+	size = (size+3)>>2;
+	size <<= 2;
+
+	// hold return value
+	nodelist_node_t *tmp;
+	if(  size > MAX_LIST_INDEX  ) {
+		// too large: just use malloc anyway
+		tmp = (nodelist_node_t *)xmalloc(size);
+		magazine.allocs[NUM_LIST] ++;
+#ifdef DEBUG_FREELIST
+		tmp->magic = 0xAA;
+		tmp->free = 0;
+		tmp->size = size/4;
+#endif
+		return tmp;
+	}
+
+	const int idx = size/4;
+	if(  magazine.epoch != freelist_epoch  ) {
+		// all nodes were freed meanwhile
+		magazine.clear();
+	}
+	if(  magazine.list[idx] == NULL  ) {
+		lock_lists(idx);
+		refill_magazine(idx, size);
+		book_magazine_stats(idx);
+		unlock_lists();
 	}
 
-	// return first node of list
-	tmp = *list;
-	*list = tmp->next;
+	// return first node of magazine
+	tmp = magazine.list[idx];
+	magazine.list[idx] = tmp->next;
+	magazine.count[idx] --;
+	magazine.allocs[idx] ++;
 
 #ifdef USE_VALGRIND_MEMCHECK
 	// tell valgrind that we now have access to a chunk of size bytes
@@ -155,11 +293,6 @@ void *freelist_t::gimme_node(size_t size)
 	VALGRIND_MAKE_MEM_UNDEFINED(tmp, size);
 #endif
 
-#ifdef MULTI_THREAD
-	error = pthread_mutex_unlock( &freelist_mutex );
-	assert(error == 0);
-#endif
-
 #ifdef DEBUG_FREELIST
 	tmp->magic = 0x5555;
 	tmp->free = 0;
@@ -171,7 +304,6 @@ void *freelist_t::gimme_node(size_t size)
 
 void freelist_t::putback_node( size_t size, void *p )
 {
-	nodelist_node_t ** list = NULL;
 	if(  size==0  ||  p==NULL  ) {
 		return;
 	}
@@ -185,23 +317,13 @@ void freelist_t::putback_node( size_t size, void *p )
 	size = ((size+3)>>2);
 	size <<= 2;
 
-#ifdef MULTI_THREAD
-	int error = pthread_mutex_lock( &freelist_mutex );
-	assert(error == 0);
-	(void)error;
-#endif
-
 	if(  size > MAX_LIST_INDEX  ) {
 		free(p);
-#ifdef MULTI_THREAD
-		int error = pthread_mutex_unlock( &freelist_mutex );
-		assert(error == 0);
-		(void)error;
-#endif
+		magazine.frees[NUM_LIST] ++;
 		return;
 	}
 
-	list = &(all_lists[size/4]);
+	const int idx = size/4;
 
 #ifdef USE_VALGRIND_MEMCHECK
 	// tell valgrind that we keep access to a nodelist_node_t within the memory chunk
@@ -217,13 +339,44 @@ void freelist_t::putback_node( size_t size, void *p )
 	assert(  tmp->magic == 0x5555  &&  tmp->free == 0  &&  tmp->size == size/4  );
 	tmp->free = 1;
 #endif
-	tmp->next = *list;
-	*list = tmp;
+	if(  magazine.epoch != freelist_epoch  ) {
+		magazine.clear();
+	}
+	tmp->next = magazine.list[idx];
+	magazine.list[idx] = tmp;
+	magazine.count[idx] ++;
+	magazine.frees[idx] ++;
+
+	if(  magazine.count[idx] > 2*MAGAZINE_BATCH  ) {
+		// keep a full batch for the next requests of this thread
+		lock_lists(idx);
+		flush_magazine(idx, MAGAZINE_BATCH);
+		book_magazine_stats(idx);
+		unlock_lists();
+	}
+}
 
-#ifdef MULTI_THREAD
-	error = pthread_mutex_unlock( &freelist_mutex );
-	assert(error == 0);
-#endif
+
+void freelist_t::reset_statistics()
+{
+	lock_lists(NUM_LIST);
+	for(  int i=0;  i<=NUM_LIST;  i++  ) {
+		all_stats[i] = stats_t();
+		magazine.allocs[i] = 0;
+		magazine.frees[i] = 0;
+	}
+	unlock_lists();
+}
+
+
+void freelist_t::get_statistics(stats_t *stats)
+{
+	lock_lists(NUM_LIST);
+	for(  int i=0;  i<=NUM_LIST;  i++  ) {
+		book_magazine_stats(i);
+		stats[i] = all_stats[i];
+	}
+	unlock_lists();
 }
 
 
@@ -246,5 +399,7 @@ void freelist_t::free_all_nodes()
 	for( int i=0;  i<NUM_LIST;  i++  ) {
 		all_lists[i] = NULL;
 	}
+	// the magazines of all threads are stale now
+	freelist_epoch ++;
 	printf("freelist_t::free_all_nodes(): ok\n");
 }
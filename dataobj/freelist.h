@@ -9,19 +9,46 @@
 
 #include <cstddef>
 
+#include "../simtypes.h"
+
+
 
 /**
  * Helper class to organize small memory objects i.e. nodes for linked lists
- * and such.
+ * and such. Every thread keeps a small magazine of free nodes per size, so
+ * the global lists (and their mutex) are only needed to exchange batches.
  */
 class freelist_t
 {
 public:
+	/// counters of one size class
+	struct stats_t
+	{
+		uint64 allocs;
+		uint64 frees;
+		uint64 refills;   ///< batches moved from the global list to a magazine
+		uint64 returns;   ///< batches moved from a magazine back to the global list
+		uint64 contended; ///< times the mutex was already taken
+		uint32 chunks;    ///< memory chunks allocated
+
+		stats_t() : allocs(0), frees(0), refills(0), returns(0), contended(0), chunks(0) {}
+	};
+
+	/// number of size classes in the statistics (the last one counts the larger nodes)
+	enum { STATS_COUNT = 34 };
+
 	static void *gimme_node( size_t size );
 	static void putback_node( size_t size, void *p );
 
 	// clears all list memories
 	static void free_all_nodes();
+
+	/**
+	 * Fills @p stats (STATS_COUNT entries, index = size/4). The allocations
+	 * of other threads are only counted up to their last batch exchange.
+	 */
+	static void get_statistics( stats_t *stats );
+	static void reset_statistics();
 };
 
 #endif
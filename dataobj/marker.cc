@@ -21,12 +21,17 @@ void marker_t::init(int world_size_x, int world_size_y)
 	if( bits_length != new_bits_length  ) {
 		bits_length = new_bits_length;
 		delete [] bits;
+		delete [] bits_epoch;
 		if(bits_length) {
-			bits = new unsigned char[bits_length];
+			bits = new uint64[bits_length];
+			bits_epoch = new uint16[bits_length];
 		}
 		else {
 			bits = NULL;
+			bits_epoch = NULL;
 		}
+		// force clearing the new field
+		epoch = 0xFFFF;
 	}
 	unmark_all();
 }
@@ -54,14 +59,20 @@ marker_t& marker_t::instance(int world_size_x, int world_size_y, uint32 thread_n
 marker_t::~marker_t()
 {
 	delete [] bits;
+	delete [] bits_epoch;
 }
 
 void marker_t::unmark_all()
 {
-	if(bits) {
-		MEMZERON(bits, bits_length);
+	epoch ++;
+	if(  epoch == 0  ||  epoch == 0xFFFF  ) {
+		// epoch wrapped (or new field): really clear everything once
+		if(bits_epoch) {
+			MEMZERON(bits_epoch, bits_length);
+		}
+		more.clear();
+		epoch = 1;
 	}
-	more.clear();
 }
 
 void marker_t::mark(const grund_t *gr)
@@ -70,10 +81,10 @@ void marker_t::mark(const grund_t *gr)
 		if(gr->ist_karten_boden()) {
 			// ground level
 			const int bit = gr->get_pos().y*cached_size_x+gr->get_pos().x;
-			bits[bit/bit_unit] |= 1 << (bit & bit_mask);
+			get_word(bit) |= (uint64)1 << (bit & bit_mask);
 		}
 		else {
-			more.set(gr, true);
+			more.set(gr, epoch);
 		}
 	}
 }
@@ -84,7 +95,7 @@ void marker_t::unmark(const grund_t *gr)
 		if(gr->ist_karten_boden()) {
 			// ground level
 			const int bit = gr->get_pos().y*cached_size_x+gr->get_pos().x;
-			bits[bit/bit_unit] &= ~(1 << (bit & bit_mask));
+			get_word(bit) &= ~((uint64)1 << (bit & bit_mask));
 		}
 		else {
 			more.remove(gr);
@@ -100,10 +111,10 @@ bool marker_t::is_marked(const grund_t *gr) const
 	if(gr->ist_karten_boden()) {
 		// ground level
 		const int bit = gr->get_pos().y*cached_size_x+gr->get_pos().x;
-		return (bits[bit/bit_unit] & (1 << (bit & bit_mask))) != 0;
+		return test_bit(bit);
 	}
 	else {
-		return more.get(gr);
+		return more.get(gr) == epoch;
 	}
 }
 
@@ -113,13 +124,15 @@ bool marker_t::test_and_mark(const grund_t *gr)
 		if(gr->ist_karten_boden()) {
 			// ground level
 			const int bit = gr->get_pos().y*cached_size_x+gr->get_pos().x;
-			if ((bits[bit/bit_unit] & (1 << (bit & bit_mask))) != 0) {
+			uint64 &word = get_word(bit);
+			const uint64 mask = (uint64)1 << (bit & bit_mask);
+			if(  (word & mask) != 0  ) {
 				return true;
 			}
-			bits[bit/bit_unit] |= 1 << (bit & bit_mask);
+			word |= mask;
 		}
 		else {
-			return more.set(gr, true);
+			return more.set(gr, epoch) == epoch;
 		}
 	}
 	return false;
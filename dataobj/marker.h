@@ -16,17 +16,22 @@ class grund_t;
 /**
  * Class to mark tiles as visited during route search.
  * Singleton.
+ *
+ * Unmarking all tiles is O(1): every word of the bit-field carries the epoch
+ * in which it was last written and counts as empty in any other epoch, so
+ * unmark_all() just starts a new epoch.
  */
 class marker_t {
-	// added bit mask, because it allows a more efficient
-	// implementation (use & instead of %)
 	enum {
-		bit_unit = (8 * sizeof(unsigned char)),
-		bit_mask = (8 * sizeof(unsigned char))-1
+		bit_unit = (8 * sizeof(uint64)),
+		bit_mask = (8 * sizeof(uint64))-1
 	};
 
 	/// bit-field to mark ground tiles
-	unsigned char *bits;
+	uint64 *bits;
+
+	/// epoch of each word of the bit-field
+	uint16 *bits_epoch;
 
 	/// length of field
 	int bits_length;
@@ -34,8 +39,11 @@ class marker_t {
 	/// bit-field is made for this x-size
 	int cached_size_x;
 
-	/// hashtable to mark non-ground tiles (bridges, tunnels)
-	ptrhashtable_tpl <const grund_t *, bool, N_BAGS_LARGE> more;
+	/// current epoch, never 0
+	uint16 epoch;
+
+	/// hashtable to mark non-ground tiles (bridges, tunnels) with the epoch they were marked in
+	flat_ptrhashtable_tpl<const grund_t *, uint16> more;
 
 	/**
 	 * Initializes marker. Set all tiles to not marked.
@@ -44,6 +52,23 @@ class marker_t {
 	 */
 	void init(int world_size_x, int world_size_y);
 
+	/// @returns the word of the bit-field for this bit, cleared if from an older epoch
+	uint64 &get_word(int bit)
+	{
+		const int w = bit / bit_unit;
+		if(  bits_epoch[w] != epoch  ) {
+			bits_epoch[w] = epoch;
+			bits[w] = 0;
+		}
+		return bits[w];
+	}
+
+	bool test_bit(int bit) const
+	{
+		const int w = bit / bit_unit;
+		return bits_epoch[w] == epoch  &&  (bits[w] & ((uint64)1 << (bit & bit_mask))) != 0;
+	}
+
 	/// the instance (single threaded only)
 	static marker_t the_instance;
 
@@ -52,7 +77,7 @@ public:
 	/// For running multi-threadedly
 	static marker_t* markers;
 
-	marker_t() : bits(NULL) { bits_length = 0; init(0, 0); }
+	marker_t() : bits(NULL), bits_epoch(NULL), epoch(0) { bits_length = 0; init(0, 0); }
 	~marker_t();
 
 	/**
@@ -46,6 +46,8 @@
 #include "../dataobj/loadsave.h"
 #include "../dataobj/freelist.h"
 #include "../dataobj/environment.h"
+#include "../tpl/vector_tpl.h"
+#include "../tpl/ptrhashtable_tpl.h"
 
 #include "objlist.h"
 
@@ -166,6 +168,7 @@ objlist_t::objlist_t()
 	obj.one = NULL;
 	capacity = 0;
 	top = 0;
+	has_draw_list = false;
 }
 
 
@@ -194,6 +197,7 @@ objlist_t::~objlist_t()
 	}
 	obj.some = NULL;
 	capacity = top = 0;
+	free_draw_list();
 }
 
 
@@ -299,6 +303,7 @@ inline void objlist_t::intern_insert_at(obj_t* new_obj, uint8 pri)
 // only used internal for loading. DO NOT USE OTHERWISE!
 bool objlist_t::append(obj_t *new_obj)
 {
+	invalidate_draw_list();
 	if(capacity==0) {
 		// the first one save direct
 		obj.one = new_obj;
@@ -395,6 +400,7 @@ bool compare_trees(const obj_t *tree1, const obj_t *tree2)
 
 void objlist_t::sort_trees(uint8 index, uint8 count)
 {
+	invalidate_draw_list();
 	if(top>=index+count) {
 		std::sort(&obj.some[index], &obj.some[index+count], compare_trees);
 	}
@@ -403,6 +409,7 @@ void objlist_t::sort_trees(uint8 index, uint8 count)
 
 bool objlist_t::add(obj_t* new_obj)
 {
+	invalidate_draw_list();
 	if(capacity==0) {
 		// the first one save direct
 		obj.one = new_obj;
@@ -486,6 +493,7 @@ bool objlist_t::add(obj_t* new_obj)
 // since it does not shrink list or checks for ownership
 obj_t *objlist_t::remove_last()
 {
+	invalidate_draw_list();
 	obj_t *last_obj=NULL;
 	if(capacity==0) {
 		// nothing
@@ -508,6 +516,7 @@ obj_t *objlist_t::remove_last()
 
 bool objlist_t::remove(const obj_t* remove_obj)
 {
+	invalidate_draw_list();
 	if(  capacity == 0  ) {
 		return false;
 	}
@@ -563,6 +572,7 @@ static void local_delete_object(obj_t *remove_obj, player_t *player)
 
 bool objlist_t::loesche_alle(player_t *player, uint8 offset)
 {
+	invalidate_draw_list();
 	if(top<=offset) {
 		return false;
 	}
@@ -620,6 +630,7 @@ const char *objlist_t::kann_alle_entfernen(const player_t *player, uint8 offset)
  */
 void objlist_t::calc_image()
 {
+	invalidate_draw_list();
 	if(capacity==0) {
 		// nothing
 	}
@@ -1131,7 +1142,8 @@ void objlist_t::display_obj_quick_and_dirty( const sint16 xpos, const sint16 ypo
 		obj.some[n]->display_after( xpos, ypos, clip_num );
 #else
 		obj.some[n]->display_after( xpos, ypos, is_global );
-		if(  is_global  ) {
+		if(  is_global  &&  obj.some[n]->get_flag( obj_t::dirty )  ) {
+			invalidate_draw_list();
 			obj.some[n]->clear_flag( obj_t::dirty );
 		}
 #endif
@@ -1139,6 +1151,190 @@ void objlist_t::display_obj_quick_and_dirty( const sint16 xpos, const sint16 ypo
 }
 
 
+/**
+ * The draw list stores for each non-moving object the stack of its background
+ * images, or marks it to be drawn by obj_t::display() if it has an outline.
+ * It is only built for tiles with several objects and only for the tile itself
+ * in the main view (the neighbours draw parts of it live). It is rebuilt after
+ * anything on the tile or the global hide settings changed. Objects being dirty
+ * or highlighted are always drawn live.
+ * The lists are kept in a table outside of the object lists, since only a few
+ * of the tiles on the map are ever visible.
+ */
+struct draw_list_t
+{
+	enum { LIVE = 0xFFFF };
+
+	struct entry_t {
+		const obj_t *obj;
+		uint16 first_image; ///< index into images or LIVE
+	};
+
+	uint32 epoch;       ///< valid if equal to draw_list_epoch
+	uint8 start_offset;
+	uint8 end;          ///< index of the first object not in the list
+	uint8 hide_state;
+	vector_tpl<entry_t> entries;
+	vector_tpl<image_id> images; ///< image stacks, each terminated by IMG_EMPTY
+
+	draw_list_t() : epoch(0), start_offset(0), end(0), hide_state(0) {}
+};
+
+static flat_ptrhashtable_tpl<const objlist_t *, draw_list_t *> draw_lists;
+
+// bumped to invalidate all draw lists at once
+static uint32 draw_list_epoch = 1;
+
+#ifdef MULTI_THREAD
+/*
+ * The drawing threads only read the draw lists. Missing or outdated lists are
+ * queued per thread and built by the main thread after drawing, before anything
+ * on the map can change.
+ */
+struct pending_draw_list_t
+{
+	const objlist_t *list;
+	uint8 start_offset;
+};
+static vector_tpl<pending_draw_list_t> pending_draw_lists[MAX_THREADS];
+#endif
+
+
+static inline uint8 get_draw_list_hide_state()
+{
+	return env_t::hide_buildings | (env_t::hide_trees << 2) | (env_t::hide_with_transparency << 3);
+}
+
+
+void objlist_t::prepare_draw_lists(bool invalidate_all)
+{
+	if(  invalidate_all  ) {
+		draw_list_epoch++;
+		if(  draw_list_epoch == 0  ) {
+			draw_list_epoch = 1;
+		}
+	}
+}
+
+
+void objlist_t::finish_draw_lists()
+{
+#ifdef MULTI_THREAD
+	for(  int t = 0;  t < MAX_THREADS;  t++  ) {
+		for(  uint32 i = 0;  i < pending_draw_lists[t].get_count();  i++  ) {
+			const pending_draw_list_t &pending = pending_draw_lists[t][i];
+			// tiles at the seams are queued by both threads
+			draw_list_t *const *dl = draw_lists.access( pending.list );
+			if(  dl == NULL  ||  (*dl)->epoch != draw_list_epoch  ) {
+				pending.list->build_draw_list( pending.start_offset );
+			}
+		}
+		pending_draw_lists[t].clear();
+	}
+#endif
+}
+
+
+void objlist_t::invalidate_draw_list() const
+{
+	if(  has_draw_list  ) {
+		draw_lists.get( this )->epoch = 0;
+	}
+}
+
+
+void objlist_t::free_draw_list()
+{
+	if(  has_draw_list  ) {
+		delete draw_lists.remove( this );
+		has_draw_list = false;
+	}
+}
+
+
+void objlist_t::build_draw_list( const uint8 start_offset ) const
+{
+	draw_list_t *dl;
+	if(  has_draw_list  ) {
+		dl = draw_lists.get( this );
+		dl->entries.clear();
+		dl->images.clear();
+	}
+	else {
+		dl = new draw_list_t();
+		draw_lists.put( this, dl );
+		has_draw_list = true;
+	}
+
+	uint8 n = start_offset;
+	for(  ;  n < top;  n++  ) {
+		const obj_t *o = bei(n);
+		if(  o->is_moving()  ) {
+			break;
+		}
+		draw_list_t::entry_t entry;
+		entry.obj = o;
+		if(  o->get_outline_image() != IMG_EMPTY  ||  o->get_outline_colour()  ) {
+			entry.first_image = draw_list_t::LIVE;
+		}
+		else {
+			entry.first_image = dl->images.get_count();
+			image_id image = o->get_image();
+			for(  int j = 1;  image != IMG_EMPTY;  j++  ) {
+				dl->images.append( image );
+				image = o->get_image( j );
+			}
+			dl->images.append( IMG_EMPTY );
+		}
+		dl->entries.append( entry );
+	}
+	dl->start_offset = start_offset;
+	dl->end = n;
+	dl->hide_state = get_draw_list_hide_state();
+	dl->epoch = draw_list_epoch;
+}
+
+
+/**
+ * Draws the background images of the non-moving objects from the draw list,
+ * (re)building it first if needed.
+ * @return index of the first moving thing or 255 if the objects must be drawn normally
+ */
+uint8 objlist_t::display_draw_list( const sint16 xpos, const sint16 ypos, const uint8 start_offset  CLIP_NUM_DEF) const
+{
+	if(  top < 2  ) {
+		// a single object is as fast drawn directly
+		return 255;
+	}
+
+	draw_list_t *dl = has_draw_list ? draw_lists.get( this ) : NULL;
+	if(  dl == NULL  ||  dl->epoch != draw_list_epoch  ||  dl->start_offset != start_offset  ||  dl->hide_state != get_draw_list_hide_state()  ) {
+#ifdef MULTI_THREAD
+		// the table must not change while the threads are drawing
+		pending_draw_list_t pending;
+		pending.list = this;
+		pending.start_offset = start_offset;
+		pending_draw_lists[clip_num].append( pending );
+		return 255;
+#else
+		build_draw_list( start_offset );
+		dl = draw_lists.get( this );
+#endif
+	}
+
+	for(  uint32 i = 0;  i < dl->entries.get_count();  i++  ) {
+		const draw_list_t::entry_t &entry = dl->entries[i];
+		if(  entry.first_image == draw_list_t::LIVE  ||  entry.obj->get_flag( obj_t::dirty )  ||  entry.obj->get_flag( obj_t::highlight )  ) {
+			entry.obj->display( xpos, ypos  CLIP_NUM_PAR);
+		}
+		else {
+			entry.obj->display_images( &dl->images[entry.first_image], xpos, ypos  CLIP_NUM_PAR);
+		}
+	}
+	return dl->end;
+}
+
+
 /**
  * Routine to display background images of non-moving things
  * powerlines have to be drawn after vehicles (and thus are in the obj-array inserted after vehicles)
@@ -1156,12 +1352,19 @@ inline bool local_display_obj_bg(const obj_t *obj, const sint16 xpos, const sint
 	return display_obj;
 }
 
-uint8 objlist_t::display_obj_bg( const sint16 xpos, const sint16 ypos, const uint8 start_offset  CLIP_NUM_DEF) const
+uint8 objlist_t::display_obj_bg( const sint16 xpos, const sint16 ypos, const uint8 start_offset, const bool use_draw_list  CLIP_NUM_DEF) const
 {
 	if(  start_offset >= top  ) {
 		return start_offset;
 	}
 
+	if(  use_draw_list  ) {
+		const uint8 end = display_draw_list( xpos, ypos, start_offset  CLIP_NUM_PAR);
+		if(  end != 255  ) {
+			return end;
+		}
+	}
+
 	if(  capacity == 1  ) {
 		return local_display_obj_bg( obj.one, xpos, ypos  CLIP_NUM_PAR);
 	}
@@ -1257,7 +1460,9 @@ void objlist_t::display_obj_fg( const sint16 xpos, const sint16 ypos, const uint
 		obj.one->display_after( xpos, ypos, clip_num );
 #else
 		obj.one->display_after( xpos, ypos, is_global );
-		if(  is_global  ) {
+		if(  is_global  &&  obj.one->get_flag(obj_t::dirty)  ) {
+			// the image may have changed
+			invalidate_draw_list();
 			obj.one->clear_flag(obj_t::dirty);
 		}
 #endif
@@ -1273,7 +1478,8 @@ void objlist_t::display_obj_fg( const sint16 xpos, const sint16 ypos, const uint
 		obj.some[n]->display_after( xpos, ypos, clip_num );
 #else
 		obj.some[n]->display_after( xpos, ypos, is_global );
-		if(  is_global  ) {
+		if(  is_global  &&  obj.some[n]->get_flag( obj_t::dirty )  ) {
+			invalidate_draw_list();
 			obj.some[n]->clear_flag( obj_t::dirty );
 		}
 #endif
@@ -1291,12 +1497,19 @@ void objlist_t::display_obj_overlay(const sint16 xpos, const sint16 ypos) const
 
 	if(  capacity == 1  ) {
 		obj.one->display_overlay( xpos, ypos );
-		obj.one->clear_flag( obj_t::dirty );
+		if(  obj.one->get_flag( obj_t::dirty )  ) {
+			// the image may have changed
+			invalidate_draw_list();
+			obj.one->clear_flag( obj_t::dirty );
+		}
 	}
 	else {
 		for(  size_t n = top;  n-- != 0;    ) {
 			obj.some[n]->display_overlay( xpos, ypos );
-			obj.some[n]->clear_flag( obj_t::dirty );
+			if(  obj.some[n]->get_flag( obj_t::dirty )  ) {
+				invalidate_draw_list();
+				obj.some[n]->clear_flag( obj_t::dirty );
+			}
 		}
 	}
 }
@@ -1305,6 +1518,7 @@ void objlist_t::display_obj_overlay(const sint16 xpos, const sint16 ypos) const
 
 void objlist_t::check_season(const bool calc_only_season_change)
 {
+	invalidate_draw_list();
 	if(  0 == top  ) {
 		return;
 	}
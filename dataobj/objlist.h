@@ -40,6 +40,13 @@ private:
 	 */
 	uint8 top;
 
+	/**
+	 * True if there are cached background images of the non-moving objects
+	 * for the main view (see display_draw_list()). Only tiles with several
+	 * objects get one, and the lists themselves are stored outside.
+	 */
+	mutable bool has_draw_list;
+
 	void set_capacity(uint16 new_cap);
 
 	bool grow_capacity();
@@ -54,6 +61,12 @@ private:
 	// this will automatically give the right order for citycars and the like ...
 	bool intern_add_moving(obj_t* new_obj);
 
+	// draws from the draw list, returns 255 if it cannot be used
+	uint8 display_draw_list(const sint16 xpos, const sint16 ypos, const uint8 start_offset  CLIP_NUM_DEF) const;
+
+	// collects the images of the draw list
+	void build_draw_list(const uint8 start_offset) const;
+
 	objlist_t(objlist_t const&);
 	objlist_t& operator=(objlist_t const&);
 
@@ -116,6 +129,28 @@ public:
 	 */
 	void check_season(const bool calc_only_season_change);
 
+	/**
+	 * Forget the cached draw list, since the objects or their images have changed
+	 */
+	void invalidate_draw_list() const;
+
+	/**
+	 * Frees the cached draw list (when the tile left the main view)
+	 */
+	void free_draw_list();
+
+	/**
+	 * Called by the main view before each frame
+	 * @param invalidate_all true if everything is redrawn (zoom, rotation, settings ...)
+	 */
+	static void prepare_draw_lists(bool invalidate_all);
+
+	/**
+	 * Called by the main view after each frame, builds the draw lists
+	 * the drawing threads could not build themselves
+	 */
+	static void finish_draw_lists();
+
 	/** display all things, faster, but will lead to clipping errors
 	 */
 #ifdef MULTI_THREAD
@@ -126,8 +161,9 @@ public:
 
 	/**
 	* display all things, called by the routines in grund_t
+	* @param use_draw_list draw (and build) the cached images, only for the own tile in the main view
 	*/
-	uint8 display_obj_bg(const sint16 xpos, const sint16 ypos, const uint8 start_offset  CLIP_NUM_DEF) const;
+	uint8 display_obj_bg(const sint16 xpos, const sint16 ypos, const uint8 start_offset, const bool use_draw_list  CLIP_NUM_DEF) const;
 	uint8 display_obj_vh(const sint16 xpos, const sint16 ypos, const uint8 start_offset, const ribi_t::ribi ribi, const bool ontile  CLIP_NUM_DEF) const;
 
 #ifdef MULTI_THREAD
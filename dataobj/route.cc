@@ -37,6 +37,7 @@
 
 // binary heap, the fastest
 #include "../tpl/binary_heap_tpl.h"
+#include "../tpl/indexed_heap_tpl.h"
 
 
 #ifdef DEBUG_ROUTES
@@ -46,6 +47,101 @@
 bool route_t::suspend_private_car_routing = false;
 
 
+/**
+ * The open nodes of a search by their tile, to find the node of a tile
+ * already in the queue. Open addressing with linear probing; each slot
+ * carries the epoch of the search that wrote it, so clear() is O(1).
+ */
+class open_nodes_t
+{
+	struct slot_t
+	{
+		const grund_t *gr;
+		route_t::ANode *node;
+		uint32 epoch;
+	};
+
+	slot_t *slots;
+	uint32 mask;
+	uint32 count;
+	uint32 epoch;
+
+	uint32 get_index(const grund_t *gr) const
+	{
+		return (uint32)((((size_t)gr) >> 4) * 2654435761u) & mask;
+	}
+
+	void resize(uint32 new_size)
+	{
+		slot_t *old_slots = slots;
+		const uint32 old_size = old_slots ? mask+1 : 0;
+		slots = new slot_t[new_size];
+		mask = new_size-1;
+		for(  uint32 i=0;  i<new_size;  i++  ) {
+			slots[i].epoch = 0;
+		}
+		count = 0;
+		for(  uint32 i=0;  i<old_size;  i++  ) {
+			if(  old_slots[i].epoch == epoch  ) {
+				set( old_slots[i].gr, old_slots[i].node );
+			}
+		}
+		delete [] old_slots;
+	}
+
+public:
+	open_nodes_t() : slots(NULL), mask(0), count(0), epoch(1) { resize(4096); }
+	~open_nodes_t() { delete [] slots; }
+
+	void clear()
+	{
+		count = 0;
+		if(  ++epoch == 0  ) {
+			for(  uint32 i=0;  i<=mask;  i++  ) {
+				slots[i].epoch = 0;
+			}
+			epoch = 1;
+		}
+	}
+
+	route_t::ANode *get(const grund_t *gr) const
+	{
+		for(  uint32 i=get_index(gr);  slots[i].epoch == epoch;  i=(i+1)&mask  ) {
+			if(  slots[i].gr == gr  ) {
+				return slots[i].node;
+			}
+		}
+		return NULL;
+	}
+
+	void set(const grund_t *gr, route_t::ANode *node)
+	{
+		if(  2*(count+1) > mask+1  ) {
+			resize( 2*(mask+1) );
+		}
+		uint32 i = get_index(gr);
+		for(  ;  slots[i].epoch == epoch;  i=(i+1)&mask  ) {
+			if(  slots[i].gr == gr  ) {
+				slots[i].node = node;
+				return;
+			}
+		}
+		slots[i].gr = gr;
+		slots[i].node = node;
+		slots[i].epoch = epoch;
+		count++;
+	}
+};
+
+
+/// queue and open nodes of intern_calc_route(), kept per thread and nodes array
+struct route_search_scratch_t
+{
+	indexed_heap_tpl<route_t::ANode *> queue;
+	open_nodes_t open;
+};
+
+
 void route_t::append(const route_t *r)
 {
 	assert(r != NULL);
@@ -425,11 +521,6 @@ bool route_t::find_route(karte_t *welt, const koord3d start, test_driver_t *tdri
 	// nothing in lists
 	marker_t& marker = marker_t::instance(welt->get_size().x, welt->get_size().y, karte_t::marker_index);
 
-	binary_heap_tpl <ANode *> queue;
-
-	// nothing in lists
-	queue.clear();
-
 	// we clear it here probably twice: does not hurt ...
 	route.clear();
 
@@ -441,6 +532,13 @@ bool route_t::find_route(karte_t *welt, const koord3d start, test_driver_t *tdri
 	ANode *nodes;
 	uint8 ni = GET_NODES(&nodes);
 
+	// keep the queue memory between searches
+	static thread_local binary_heap_tpl <ANode *> queues[MAX_NODES_ARRAY];
+	binary_heap_tpl <ANode *> &queue = queues[ni];
+
+	// nothing in lists
+	queue.clear();
+
 #ifdef USE_VALGRIND_MEMCHECK
 	VALGRIND_MAKE_MEM_UNDEFINED(nodes, sizeof(ANode)*MAX_STEP);
 #endif
@@ -1005,11 +1103,14 @@ route_t::route_result_t route_t::intern_calc_route(karte_t *welt, const koord3d
 		INIT_NODES(welt->get_settings().get_max_route_steps(), welt->get_size());
 	}
 
-	binary_heap_tpl <ANode *> queue;
-
 	ANode *nodes;
 	uint8 ni = GET_NODES(&nodes);
 
+	// keep the queue and the table of open nodes between searches
+	static thread_local route_search_scratch_t scratch[MAX_NODES_ARRAY];
+	indexed_heap_tpl<ANode *> &queue = scratch[ni].queue;
+	open_nodes_t &open = scratch[ni].open;
+
 #ifdef USE_VALGRIND_MEMCHECK
 	VALGRIND_MAKE_MEM_UNDEFINED(nodes, sizeof(ANode)*MAX_STEP);
 #endif
@@ -1028,6 +1129,7 @@ route_t::route_result_t route_t::intern_calc_route(karte_t *welt, const koord3d
 	tmp->count = 0;
 	tmp->ribi_from = ribi_t::none;
 	tmp->jps_ribi  = ribi_t::all;
+	tmp->heap_index = 0;
 
 	// nothing in lists
 	marker_t& marker = marker_t::instance(welt->get_size().x, welt->get_size().y, karte_t::marker_index);
@@ -1037,7 +1139,9 @@ route_t::route_result_t route_t::intern_calc_route(karte_t *welt, const koord3d
 
 	// clear the queue (should be empty anyhow)
 	queue.clear();
+	open.clear();
 	queue.insert(tmp);
+	open.set(tmp->gr, tmp);
 	ANode* new_top = NULL;
 
 	const uint8 enforce_weight_limits = welt->get_settings().get_enforce_weight_limits();
@@ -1295,11 +1399,24 @@ route_t::route_result_t route_t::intern_calc_route(karte_t *welt, const koord3d
 
 				const uint32 new_f = (new_g + dist + turns * 3 + costup) * 10;
 
-				// add new
-				ANode* k = &nodes[step];
-				step ++;
-				if (route_t::max_used_steps < step)
-					route_t::max_used_steps = step;
+				// already in the queue on another route?
+				ANode* k = open.get(to);
+				if(  k  ) {
+					if(  k->f < new_f  ||  (k->f == new_f  &&  k->g <= new_g)  ) {
+						// the other route is at least as good
+						continue;
+					}
+					// take the node over for this route (it was not expanded yet)
+				}
+				else {
+					// add new
+					k = &nodes[step];
+					step ++;
+					if (route_t::max_used_steps < step)
+						route_t::max_used_steps = step;
+					k->heap_index = 0;
+					open.set(to, k);
+				}
 
 				k->parent = tmp;
 				k->gr = to;
@@ -1325,7 +1442,23 @@ route_t::route_result_t route_t::intern_calc_route(karte_t *welt, const koord3d
 					}
 				}
 
-				if(  new_f <= topnode_f  ) {
+				if(  k->heap_index  ) {
+					// lowered the cost of a queued node
+					queue.decrease_key( k );
+					if(  new_f <= topnode_f  ) {
+						// it is the best one now
+						topnode_f = new_f;
+						if(  new_top  ) {
+							queue.insert(new_top);
+							new_top = NULL;
+						}
+					}
+				}
+				else if(  k == new_top  ) {
+					// lowered the cost of the best node
+					topnode_f = new_f;
+				}
+				else if(  new_f <= topnode_f  ) {
 					// do not put in queue if the new node is the best one
 					topnode_f = new_f;
 					if(  new_top  ) {
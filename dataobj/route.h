@@ -79,6 +79,7 @@ public:
 		uint8 ribi_from; ///< we came from this direction
 		uint16 count;    ///< length of route up to here
 		uint8 jps_ribi;  ///< extra ribi mask for jump-point search
+		uint32 heap_index; ///< position in the queue of intern_calc_route(), 0 if not queued
 
 		/// sort nodes first with respect to f, then with respect to g
 		inline bool operator <= (const ANode &k) const { return f==k.f ? g<=k.g : f<=k.f; }
@@ -575,6 +575,8 @@ void scenario_t::step()
 		}
 		return;
 	}
+	// new opcode and time budget for the script
+	script->begin_step();
 
 	uint16 new_won = 0;
 	uint16 new_lost = 0;
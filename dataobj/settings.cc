@@ -444,6 +444,7 @@ settings_t::settings_t() :
 	random_counter = 0; // will be set when actually saving
 	frames_per_second = 20;
 	frames_per_step = 4;
+	subsystem_hash_interval = 256;
 
 	quick_city_growth = false;
 	assume_everywhere_connected_by_road = false;
@@ -1954,6 +1955,17 @@ void settings_t::rdwr(loadsave_t *file)
 			file->rdwr_bool(do_not_record_private_car_routes_to_distant_non_consumer_industries);
 			file->rdwr_bool(do_not_record_private_car_routes_to_city_buildings);
 		}
+
+		// the clients must hash the same sync steps and slices as the server
+		if(  !env_t::networkmode  ||  env_t::server  ) {
+			subsystem_hash_interval = env_t::subsystem_hash_interval;
+		}
+		if(  file->is_version_ex_atleast(14, 69)  ) {
+			file->rdwr_long( subsystem_hash_interval );
+		}
+		if(  !env_t::networkmode  ||  env_t::server  ) {
+			subsystem_hash_interval = env_t::subsystem_hash_interval;
+		}
 		// otherwise the default values of the last one will be used
 	}
 
@@ -2103,6 +2115,10 @@ void settings_t::parse_simuconf( tabfile_t& simuconf, sint16& disp_width, sint16
 	env_t::fps                         = contents.get_int_clamped( "frames_per_second",              env_t::fps,                       env_t::min_fps, env_t::max_fps );
 	env_t::ff_fps                      = contents.get_int_clamped( "fast_forward_frames_per_second", env_t::ff_fps,                    env_t::min_fps, env_t::max_fps );
 	env_t::num_threads                 = contents.get_int_clamped( "threads",                        env_t::num_threads,               1, MAX_THREADS );
+	env_t::image_cache_mb              = contents.get_int_clamped( "image_cache_memory",             env_t::image_cache_mb,            0, 0x7FFFFFFF );
+	env_t::script_step_ops             = contents.get_int_clamped( "script_step_opcodes",            env_t::script_step_ops,           0, 0x7FFFFFFF );
+	env_t::script_step_ms              = contents.get_int_clamped( "script_step_time",               env_t::script_step_ms,            0, 0x7FFFFFFF );
+	env_t::script_profile              = contents.get_int( "script_profile", env_t::script_profile ) != 0;
 	env_t::simple_drawing_default      = contents.get_int_clamped( "simple_drawing_tile_size",       env_t::simple_drawing_default,    2, 256 );
 	env_t::simple_drawing_fast_forward = contents.get_int( "simple_drawing_fast_forward", env_t::simple_drawing_fast_forward ) != 0;
 	env_t::visualize_schedule          = contents.get_int( "visualize_schedule",          env_t::visualize_schedule ) != 0;
@@ -2148,6 +2164,11 @@ void settings_t::parse_simuconf( tabfile_t& simuconf, sint16& disp_width, sint16
 	env_t::additional_client_frames_behind  = contents.get_int_clamped( "additional_client_frames_behind", env_t::additional_client_frames_behind,  0, INT_MAX );
 	env_t::network_frames_per_step          = contents.get_int_clamped( "server_frames_per_step",          env_t::network_frames_per_step,          1, INT_MAX );
 	env_t::server_sync_steps_between_checks = contents.get_int_clamped( "server_frames_between_checks",    env_t::server_sync_steps_between_checks, 1, INT_MAX );
+	env_t::subsystem_hash_interval          = contents.get_int_clamped( "server_frames_between_subsystem_hashes", env_t::subsystem_hash_interval, 0, INT_MAX );
+	if(  env_t::subsystem_hash_interval % env_t::server_sync_steps_between_checks  ) {
+		// the hashes are only compared at the checks
+		env_t::subsystem_hash_interval += env_t::server_sync_steps_between_checks - env_t::subsystem_hash_interval % env_t::server_sync_steps_between_checks;
+	}
 
 	env_t::pause_server_no_clients          = contents.get_int( "pause_server_no_clients",  env_t::pause_server_no_clients  ) != 0;
 	env_t::server_save_game_on_quit         = contents.get_int( "server_save_game_on_quit", env_t::server_save_game_on_quit ) != 0;
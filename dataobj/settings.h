@@ -613,6 +613,7 @@ private:
 	uint32 random_counter;
 	uint32 frames_per_second; // only used in network mode ...
 	uint32 frames_per_step;
+	uint32 subsystem_hash_interval; ///< server setting, see env_t::subsystem_hash_interval
 	uint32 server_frames_ahead;
 
 	bool drive_on_left;
@@ -835,6 +836,7 @@ public:
 	void reset_regions(sint32 old_x, sint32 old_y);
 	void rotate_regions();
 
+	void set_map_number(sint32 n) { map_number = n; }
 	sint32 get_map_number() const {return map_number;}
 
 	void set_factory_count(sint32 d) { factory_count=d; }
@@ -1169,6 +1171,7 @@ public:
 	uint32 get_random_counter() const { return random_counter; }
 	uint32 get_frames_per_second() const { return frames_per_second; }
 	uint32 get_frames_per_step() const { return frames_per_step; }
+	uint32 get_subsystem_hash_interval() const { return subsystem_hash_interval; }
 
 	bool get_quick_city_growth() const { return quick_city_growth; }
 	void set_quick_city_growth(bool value) { quick_city_growth = value; }
@@ -24,13 +24,36 @@
 #define skip_reading_pixels_if_no_graphics goto adjust_image
 #endif
 
+// largest header of all versions
+#define IMAGE_HEADER_SIZE (12)
+
+
+// without graphics backend only remember the length, a single pixel is allocated later
+static void alloc_pixels(image_t *desc, size_t len)
+{
+#if COLOUR_DEPTH != 0
+	desc->alloc(len);
+#else
+	desc->len = len;
+#endif
+}
+
+
 obj_desc_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 {
-	ALLOCA(char, desc_buf, node.size);
 	image_t* desc=NULL;
 
 	// Read data
+#if COLOUR_DEPTH != 0
+	ALLOCA(char, desc_buf, node.size);
 	fread(desc_buf, node.size, 1, fp);
+#else
+	// only the header is needed, skip the pixels
+	char desc_buf[IMAGE_HEADER_SIZE];
+	const uint32 header_size = node.size < IMAGE_HEADER_SIZE ? node.size : IMAGE_HEADER_SIZE;
+	fread(desc_buf, header_size, 1, fp);
+	fseek(fp, node.size - header_size, SEEK_CUR);
+#endif
 	char * p = desc_buf+6;
 
 	// always zero in old version, since length was always less than 65535
@@ -38,19 +61,14 @@ obj_desc_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 	uint8 version = decode_uint8(p);
 	p = desc_buf;
 
-#if COLOUR_DEPTH != 0
 	desc = new image_t();
-#else
-	// reserve space for one single pixel and initialize data
-	desc = image_t::create_single_pixel();
-#endif
 
 	if(version==0) {
 		desc->x = decode_uint8(p);
 		desc->w = decode_uint8(p);
 		desc->y = decode_uint8(p);
 		desc->h = decode_uint8(p);
-		desc->alloc(decode_uint32(p)); // len
+		alloc_pixels(desc, decode_uint32(p)); // len
 		desc->imageid = IMG_EMPTY;
 		p += 2; // dummys
 		desc->zoomable = decode_uint8(p);
@@ -78,7 +96,7 @@ obj_desc_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 		desc->w = decode_uint8(p);
 		desc->h = decode_uint8(p);
 		p++; // skip version information
-		desc->alloc(decode_uint16(p)); // len
+		alloc_pixels(desc, decode_uint16(p)); // len
 		desc->zoomable = decode_uint8(p);
 		desc->imageid = IMG_EMPTY;
 
@@ -96,7 +114,7 @@ obj_desc_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 		desc->w = decode_sint16(p);
 		p++; // skip version information
 		desc->h = decode_sint16(p);
-		desc->alloc((node.size - 10) / 2); // len
+		alloc_pixels(desc, (node.size - 10) / 2); // len
 		desc->zoomable = decode_uint8(p);
 		desc->imageid = IMG_EMPTY;
 
@@ -121,10 +139,9 @@ adjust_image:
 	if(  desc->w > 0  ) {
 		desc->w = 1;
 	}
-	if(  desc->len > 0  ) {
-		desc->len = 4;
-		memset(desc->data, 0, desc->len*sizeof(PIXVAL));
-	}
+	// reserve space for one single pixel and initialize data
+	desc->alloc( desc->len > 0 ? 4 : 0 );
+	memset(desc->data, 0, desc->len*sizeof(PIXVAL));
 	desc->x = 0;
 	desc->y = 0;
 #endif
@@ -34,6 +34,9 @@
 
 #include "obj_reader.h"
 
+// number of pak files the OS is asked to read ahead while loading a directory
+#define PAK_PREFETCH_FILES (16)
+
 
 obj_reader_t::obj_map*                                        obj_reader_t::obj_reader;
 inthashtable_tpl<obj_type, stringhashtable_tpl<obj_desc_t*, N_BAGS_LARGE>, N_BAGS_LARGE> obj_reader_t::loaded;
@@ -147,8 +150,17 @@ DBG_MESSAGE("obj_reader_t::load()","big logo %p", skinverwaltung_t::biglogosymbo
 
 DBG_MESSAGE("obj_reader_t::load()", "reading from '%s'", name.c_str());
 
+		// let the OS read the next files while the current one is parsed
+		searchfolder_t::const_iterator ahead = find.begin();
+		for(  uint i = 0;  i < PAK_PREFETCH_FILES  &&  ahead != find.end();  i++  ) {
+			dr_prefetch_file(*ahead++);
+		}
+
 		uint n = 0;
 		for(char* const& i : find) {
+			if(  ahead != find.end()  ) {
+				dr_prefetch_file(*ahead++);
+			}
 			read_file(i);
 			if ((n++ & step) == 0 && drawing) {
 				ls.set_progress(n);
@@ -0,0 +1,528 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include "blitter.h"
+
+#include <string.h>
+
+#include "../simdebug.h"
+
+
+/*
+ * The SIMD versions are only built for x86 with RGB 565 (the 555 blending
+ * masks differ) and selected at runtime, so the executable still runs on cpus
+ * without AVX2. The compiler does not need any extra flags for this.
+ */
+#if !defined RGB555  &&  (defined __GNUC__  ||  defined __clang__)  &&  (defined __x86_64__  ||  defined __i386__)
+#	define BLIT_X86
+#	define BLIT_TARGET_SSE2 __attribute__((target("sse2")))
+#	define BLIT_TARGET_AVX2 __attribute__((target("avx2")))
+#	include <immintrin.h>
+#elif !defined RGB555  &&  defined _MSC_VER  &&  (defined _M_X64  ||  defined _M_IX86)
+#	define BLIT_X86
+#	define BLIT_TARGET_SSE2
+#	define BLIT_TARGET_AVX2
+#	include <intrin.h>
+#	include <immintrin.h>
+#endif
+
+
+// pixels per chunk, when the source has to be recoded before blending
+#define BLIT_CHUNK (64)
+
+
+blitter_procs_t blitter;
+
+static blitter_isa_t current_isa = BLIT_SCALAR;
+
+
+// ------------------------------------ scalar ------------------------------------
+
+// the three blend modes: 25, 50 and 75 percent
+template<int mode> static inline PIXVAL blend_pix(PIXVAL background, PIXVAL foreground);
+template<> inline PIXVAL blend_pix<0>(PIXVAL background, PIXVAL foreground) { return 3 * rgb_shr2(background) + rgb_shr2(foreground); }
+template<> inline PIXVAL blend_pix<1>(PIXVAL background, PIXVAL foreground) { return rgb_shr1(background) + rgb_shr1(foreground); }
+template<> inline PIXVAL blend_pix<2>(PIXVAL background, PIXVAL foreground) { return rgb_shr2(background) + 3 * rgb_shr2(foreground); }
+
+
+static inline PIXVAL alpha_pix(PIXVAL dest, PIXVAL src, PIXVAL alphamap, PIXVAL alpha_mask)
+{
+	// read mask components - always 15bpp
+	uint16 masked = alphamap & alpha_mask;
+	uint16 alpha_value = (masked & 0x1f) + ((masked >> 5) & 0x1f) + ((masked >> 10) & 0x1f);
+
+	if(  alpha_value > 30  ) {
+		// opaque, just copy source
+		return src;
+	}
+	else if(  alpha_value > 0  ) {
+		alpha_value = alpha_value > 15 ? alpha_value + 1 : alpha_value;
+		return colors_blend_alpha32(dest, src, alpha_value);
+	}
+	return dest;
+}
+
+
+static void scalar_copy(PIXVAL *dest, const PIXVAL *src, uint32 len)
+{
+	memcpy( dest, src, len * sizeof(PIXVAL) );
+}
+
+
+static void scalar_recode(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, uint32 len)
+{
+	const PIXVAL *const end = src + len;
+	while(  src < end  ) {
+		*dest++ = rgbmap[*src++];
+	}
+}
+
+
+template<int mode> static void scalar_blend(PIXVAL *dest, const PIXVAL *src, uint32 len)
+{
+	const PIXVAL *const end = dest + len;
+	while(  dest < end  ) {
+		*dest = blend_pix<mode>(*dest, *src++);
+		dest++;
+	}
+}
+
+
+template<int mode> static void scalar_blend_recode(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, uint32 len)
+{
+	const PIXVAL *const end = dest + len;
+	while(  dest < end  ) {
+		*dest = blend_pix<mode>(*dest, rgbmap[*src++]);
+		dest++;
+	}
+}
+
+
+template<int mode> static void scalar_blend_colour(PIXVAL *dest, PIXVAL colour, uint32 len)
+{
+	const PIXVAL *const end = dest + len;
+	while(  dest < end  ) {
+		*dest = blend_pix<mode>(*dest, colour);
+		dest++;
+	}
+}
+
+
+static void scalar_alpha(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, PIXVAL alpha_mask, uint32 len)
+{
+	const PIXVAL *const end = dest + len;
+	while(  dest < end  ) {
+		*dest = alpha_pix(*dest, *src++, *alphamap++, alpha_mask);
+		dest++;
+	}
+}
+
+
+static void scalar_alpha_recode(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, const PIXVAL *alphamap, PIXVAL alpha_mask, uint32 len)
+{
+	const PIXVAL *const end = dest + len;
+	while(  dest < end  ) {
+		*dest = alpha_pix(*dest, rgbmap[*src++], *alphamap++, alpha_mask);
+		dest++;
+	}
+}
+
+
+#ifdef BLIT_X86
+
+/*
+ * SSE2 and AVX2 versions: 8 resp. 16 pixels at a time, the remainder is done
+ * by the scalar versions. The per channel arithmetic below gives exactly the
+ * same results as rgb_shr1/2() and colors_blend_alpha32().
+ */
+
+// ------------------------------------ SSE2 ------------------------------------
+
+BLIT_TARGET_SSE2 static inline __m128i sse2_shr1(__m128i c)
+{
+	return _mm_and_si128( _mm_srli_epi16( c, 1 ), _mm_set1_epi16( ONE_OUT ) );
+}
+
+
+BLIT_TARGET_SSE2 static inline __m128i sse2_shr2(__m128i c)
+{
+	return _mm_and_si128( _mm_srli_epi16( c, 2 ), _mm_set1_epi16( TWO_OUT ) );
+}
+
+
+template<int mode> BLIT_TARGET_SSE2 static inline __m128i sse2_blend_pix(__m128i background, __m128i foreground)
+{
+	if(  mode == 1  ) {
+		return _mm_add_epi16( sse2_shr1( background ), sse2_shr1( foreground ) );
+	}
+	// 25 percent: three quarters background, 75 percent: three quarters foreground
+	const __m128i three = sse2_shr2( mode == 0 ? background : foreground );
+	const __m128i one   = sse2_shr2( mode == 0 ? foreground : background );
+	return _mm_add_epi16( _mm_add_epi16( three, three ), _mm_add_epi16( three, one ) );
+}
+
+
+BLIT_TARGET_SSE2 static inline __m128i sse2_alpha_pix(__m128i dest, __m128i src, __m128i alphamap, __m128i alpha_mask)
+{
+	const __m128i mask5 = _mm_set1_epi16( 0x1f );
+	const __m128i masked = _mm_and_si128( alphamap, alpha_mask );
+	__m128i alpha = _mm_add_epi16( _mm_and_si128( masked, mask5 ), _mm_and_si128( _mm_srli_epi16( masked, 5 ), mask5 ) );
+	alpha = _mm_add_epi16( alpha, _mm_and_si128( _mm_srli_epi16( masked, 10 ), mask5 ) );
+	// 0 keeps dest, 1..15 stay, 16..30 get one added, above is opaque (32)
+	alpha = _mm_sub_epi16( alpha, _mm_cmpgt_epi16( alpha, _mm_set1_epi16( 15 ) ) );
+	alpha = _mm_min_epi16( alpha, _mm_set1_epi16( 32 ) );
+	const __m128i inv_alpha = _mm_sub_epi16( _mm_set1_epi16( 32 ), alpha );
+
+	const __m128i mask6 = _mm_set1_epi16( 0x3f );
+	__m128i r = _mm_add_epi16( _mm_mullo_epi16( _mm_srli_epi16( src, 11 ), alpha ), _mm_mullo_epi16( _mm_srli_epi16( dest, 11 ), inv_alpha ) );
+	__m128i g = _mm_add_epi16( _mm_mullo_epi16( _mm_and_si128( _mm_srli_epi16( src, 5 ), mask6 ), alpha ), _mm_mullo_epi16( _mm_and_si128( _mm_srli_epi16( dest, 5 ), mask6 ), inv_alpha ) );
+	__m128i b = _mm_add_epi16( _mm_mullo_epi16( _mm_and_si128( src, mask5 ), alpha ), _mm_mullo_epi16( _mm_and_si128( dest, mask5 ), inv_alpha ) );
+	r = _mm_slli_epi16( _mm_srli_epi16( r, 5 ), 11 );
+	g = _mm_slli_epi16( _mm_srli_epi16( g, 5 ), 5 );
+	b = _mm_srli_epi16( b, 5 );
+	return _mm_or_si128( _mm_or_si128( r, g ), b );
+}
+
+
+BLIT_TARGET_SSE2 static void sse2_copy(PIXVAL *dest, const PIXVAL *src, uint32 len)
+{
+	for(  ;  len >= 8;  len -= 8, dest += 8, src += 8  ) {
+		_mm_storeu_si128( (__m128i *)dest, _mm_loadu_si128( (const __m128i *)src ) );
+	}
+	while(  len--  ) {
+		*dest++ = *src++;
+	}
+}
+
+
+template<int mode> BLIT_TARGET_SSE2 static void sse2_blend(PIXVAL *dest, const PIXVAL *src, uint32 len)
+{
+	for(  ;  len >= 8;  len -= 8, dest += 8, src += 8  ) {
+		const __m128i d = _mm_loadu_si128( (const __m128i *)dest );
+		const __m128i s = _mm_loadu_si128( (const __m128i *)src );
+		_mm_storeu_si128( (__m128i *)dest, sse2_blend_pix<mode>( d, s ) );
+	}
+	scalar_blend<mode>( dest, src, len );
+}
+
+
+template<int mode> BLIT_TARGET_SSE2 static void sse2_blend_recode(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, uint32 len)
+{
+	// there is no gather in SSE2, so the colours are looked up beforehand
+	PIXVAL recoded[BLIT_CHUNK];
+	while(  len > 0  ) {
+		const uint32 n = len < BLIT_CHUNK ? len : BLIT_CHUNK;
+		scalar_recode( recoded, src, rgbmap, n );
+		sse2_blend<mode>( dest, recoded, n );
+		dest += n;
+		src += n;
+		len -= n;
+	}
+}
+
+
+template<int mode> BLIT_TARGET_SSE2 static void sse2_blend_colour(PIXVAL *dest, PIXVAL colour, uint32 len)
+{
+	const __m128i s = _mm_set1_epi16( (short)colour );
+	for(  ;  len >= 8;  len -= 8, dest += 8  ) {
+		const __m128i d = _mm_loadu_si128( (const __m128i *)dest );
+		_mm_storeu_si128( (__m128i *)dest, sse2_blend_pix<mode>( d, s ) );
+	}
+	scalar_blend_colour<mode>( dest, colour, len );
+}
+
+
+BLIT_TARGET_SSE2 static void sse2_alpha(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, PIXVAL alpha_mask, uint32 len)
+{
+	const __m128i mask = _mm_set1_epi16( (short)alpha_mask );
+	for(  ;  len >= 8;  len -= 8, dest += 8, src += 8, alphamap += 8  ) {
+		const __m128i d = _mm_loadu_si128( (const __m128i *)dest );
+		const __m128i s = _mm_loadu_si128( (const __m128i *)src );
+		const __m128i a = _mm_loadu_si128( (const __m128i *)alphamap );
+		_mm_storeu_si128( (__m128i *)dest, sse2_alpha_pix( d, s, a, mask ) );
+	}
+	scalar_alpha( dest, src, alphamap, alpha_mask, len );
+}
+
+
+BLIT_TARGET_SSE2 static void sse2_alpha_recode(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, const PIXVAL *alphamap, PIXVAL alpha_mask, uint32 len)
+{
+	PIXVAL recoded[BLIT_CHUNK];
+	while(  len > 0  ) {
+		const uint32 n = len < BLIT_CHUNK ? len : BLIT_CHUNK;
+		scalar_recode( recoded, src, rgbmap, n );
+		sse2_alpha( dest, recoded, alphamap, alpha_mask, n );
+		dest += n;
+		src += n;
+		alphamap += n;
+		len -= n;
+	}
+}
+
+
+// ------------------------------------ AVX2 ------------------------------------
+
+BLIT_TARGET_AVX2 static inline __m256i avx2_shr1(__m256i c)
+{
+	return _mm256_and_si256( _mm256_srli_epi16( c, 1 ), _mm256_set1_epi16( ONE_OUT ) );
+}
+
+
+BLIT_TARGET_AVX2 static inline __m256i avx2_shr2(__m256i c)
+{
+	return _mm256_and_si256( _mm256_srli_epi16( c, 2 ), _mm256_set1_epi16( TWO_OUT ) );
+}
+
+
+template<int mode> BLIT_TARGET_AVX2 static inline __m256i avx2_blend_pix(__m256i background, __m256i foreground)
+{
+	if(  mode == 1  ) {
+		return _mm256_add_epi16( avx2_shr1( background ), avx2_shr1( foreground ) );
+	}
+	const __m256i three = avx2_shr2( mode == 0 ? background : foreground );
+	const __m256i one   = avx2_shr2( mode == 0 ? foreground : background );
+	return _mm256_add_epi16( _mm256_add_epi16( three, three ), _mm256_add_epi16( three, one ) );
+}
+
+
+BLIT_TARGET_AVX2 static inline __m256i avx2_alpha_pix(__m256i dest, __m256i src, __m256i alphamap, __m256i alpha_mask)
+{
+	const __m256i mask5 = _mm256_set1_epi16( 0x1f );
+	const __m256i masked = _mm256_and_si256( alphamap, alpha_mask );
+	__m256i alpha = _mm256_add_epi16( _mm256_and_si256( masked, mask5 ), _mm256_and_si256( _mm256_srli_epi16( masked, 5 ), mask5 ) );
+	alpha = _mm256_add_epi16( alpha, _mm256_and_si256( _mm256_srli_epi16( masked, 10 ), mask5 ) );
+	alpha = _mm256_sub_epi16( alpha, _mm256_cmpgt_epi16( alpha, _mm256_set1_epi16( 15 ) ) );
+	alpha = _mm256_min_epi16( alpha, _mm256_set1_epi16( 32 ) );
+	const __m256i inv_alpha = _mm256_sub_epi16( _mm256_set1_epi16( 32 ), alpha );
+
+	const __m256i mask6 = _mm256_set1_epi16( 0x3f );
+	__m256i r = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_srli_epi16( src, 11 ), alpha ), _mm256_mullo_epi16( _mm256_srli_epi16( dest, 11 ), inv_alpha ) );
+	__m256i g = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_and_si256( _mm256_srli_epi16( src, 5 ), mask6 ), alpha ), _mm256_mullo_epi16( _mm256_and_si256( _mm256_srli_epi16( dest, 5 ), mask6 ), inv_alpha ) );
+	__m256i b = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_and_si256( src, mask5 ), alpha ), _mm256_mullo_epi16( _mm256_and_si256( dest, mask5 ), inv_alpha ) );
+	r = _mm256_slli_epi16( _mm256_srli_epi16( r, 5 ), 11 );
+	g = _mm256_slli_epi16( _mm256_srli_epi16( g, 5 ), 5 );
+	b = _mm256_srli_epi16( b, 5 );
+	return _mm256_or_si256( _mm256_or_si256( r, g ), b );
+}
+
+
+BLIT_TARGET_AVX2 static void avx2_copy(PIXVAL *dest, const PIXVAL *src, uint32 len)
+{
+	for(  ;  len >= 16;  len -= 16, dest += 16, src += 16  ) {
+		_mm256_storeu_si256( (__m256i *)dest, _mm256_loadu_si256( (const __m256i *)src ) );
+	}
+	while(  len--  ) {
+		*dest++ = *src++;
+	}
+}
+
+
+BLIT_TARGET_AVX2 static void avx2_recode(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, uint32 len)
+{
+	const __m256i low_word = _mm256_set1_epi32( 0xFFFF );
+	for(  ;  len >= 16;  len -= 16, dest += 16, src += 16  ) {
+		// gathers 32 bit from the 16 bit table, the upper (next) entry is masked out
+		const __m256i index_lo = _mm256_cvtepu16_epi32( _mm_loadu_si128( (const __m128i *)src ) );
+		const __m256i index_hi = _mm256_cvtepu16_epi32( _mm_loadu_si128( (const __m128i *)(src + 8) ) );
+		const __m256i lo = _mm256_and_si256( _mm256_i32gather_epi32( (const int *)rgbmap, index_lo, 2 ), low_word );
+		const __m256i hi = _mm256_and_si256( _mm256_i32gather_epi32( (const int *)rgbmap, index_hi, 2 ), low_word );
+		// packing works within the 128 bit lanes, so the quadwords must be reordered
+		_mm256_storeu_si256( (__m256i *)dest, _mm256_permute4x64_epi64( _mm256_packus_epi32( lo, hi ), 0xD8 ) );
+	}
+	scalar_recode( dest, src, rgbmap, len );
+}
+
+
+template<int mode> BLIT_TARGET_AVX2 static void avx2_blend(PIXVAL *dest, const PIXVAL *src, uint32 len)
+{
+	for(  ;  len >= 16;  len -= 16, dest += 16, src += 16  ) {
+		const __m256i d = _mm256_loadu_si256( (const __m256i *)dest );
+		const __m256i s = _mm256_loadu_si256( (const __m256i *)src );
+		_mm256_storeu_si256( (__m256i *)dest, avx2_blend_pix<mode>( d, s ) );
+	}
+	scalar_blend<mode>( dest, src, len );
+}
+
+
+template<int mode> BLIT_TARGET_AVX2 static void avx2_blend_recode(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, uint32 len)
+{
+	PIXVAL recoded[BLIT_CHUNK];
+	while(  len > 0  ) {
+		const uint32 n = len < BLIT_CHUNK ? len : BLIT_CHUNK;
+		avx2_recode( recoded, src, rgbmap, n );
+		avx2_blend<mode>( dest, recoded, n );
+		dest += n;
+		src += n;
+		len -= n;
+	}
+}
+
+
+template<int mode> BLIT_TARGET_AVX2 static void avx2_blend_colour(PIXVAL *dest, PIXVAL colour, uint32 len)
+{
+	const __m256i s = _mm256_set1_epi16( (short)colour );
+	for(  ;  len >= 16;  len -= 16, dest += 16  ) {
+		const __m256i d = _mm256_loadu_si256( (const __m256i *)dest );
+		_mm256_storeu_si256( (__m256i *)dest, avx2_blend_pix<mode>( d, s ) );
+	}
+	scalar_blend_colour<mode>( dest, colour, len );
+}
+
+
+BLIT_TARGET_AVX2 static void avx2_alpha(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, PIXVAL alpha_mask, uint32 len)
+{
+	const __m256i mask = _mm256_set1_epi16( (short)alpha_mask );
+	for(  ;  len >= 16;  len -= 16, dest += 16, src += 16, alphamap += 16  ) {
+		const __m256i d = _mm256_loadu_si256( (const __m256i *)dest );
+		const __m256i s = _mm256_loadu_si256( (const __m256i *)src );
+		const __m256i a = _mm256_loadu_si256( (const __m256i *)alphamap );
+		_mm256_storeu_si256( (__m256i *)dest, avx2_alpha_pix( d, s, a, mask ) );
+	}
+	scalar_alpha( dest, src, alphamap, alpha_mask, len );
+}
+
+
+BLIT_TARGET_AVX2 static void avx2_alpha_recode(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, const PIXVAL *alphamap, PIXVAL alpha_mask, uint32 len)
+{
+	PIXVAL recoded[BLIT_CHUNK];
+	while(  len > 0  ) {
+		const uint32 n = len < BLIT_CHUNK ? len : BLIT_CHUNK;
+		avx2_recode( recoded, src, rgbmap, n );
+		avx2_alpha( dest, recoded, alphamap, alpha_mask, n );
+		dest += n;
+		src += n;
+		alphamap += n;
+		len -= n;
+	}
+}
+
+
+static bool cpu_supports(blitter_isa_t isa)
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid( info, 0 );
+	const int max_leaf = info[0];
+	__cpuid( info, 1 );
+	const bool sse2 = (info[3] & (1 << 26)) != 0;
+	// AVX needs the OS to save the ymm registers
+	const bool avx = (info[2] & (1 << 27))  &&  (info[2] & (1 << 28))  &&  (_xgetbv( 0 ) & 6) == 6;
+	bool avx2 = false;
+	if(  avx  &&  max_leaf >= 7  ) {
+		__cpuidex( info, 7, 0 );
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+#else
+	__builtin_cpu_init();
+	const bool sse2 = __builtin_cpu_supports( "sse2" );
+	const bool avx2 = __builtin_cpu_supports( "avx2" );
+#endif
+	switch(  isa  ) {
+		case BLIT_SCALAR: return true;
+		case BLIT_SSE2:   return sse2;
+		case BLIT_AVX2:   return avx2;
+		default:          return false;
+	}
+}
+
+#else
+
+static bool cpu_supports(blitter_isa_t isa)
+{
+	return isa == BLIT_SCALAR;
+}
+
+#endif
+
+
+bool blitter_select(blitter_isa_t isa)
+{
+	if(  !cpu_supports( isa )  ) {
+		return false;
+	}
+
+	switch(  isa  ) {
+#ifdef BLIT_X86
+		case BLIT_SSE2:
+			blitter.copy = sse2_copy;
+			blitter.recode = scalar_recode;
+			blitter.blend[0] = sse2_blend<0>;
+			blitter.blend[1] = sse2_blend<1>;
+			blitter.blend[2] = sse2_blend<2>;
+			blitter.blend_recode[0] = sse2_blend_recode<0>;
+			blitter.blend_recode[1] = sse2_blend_recode<1>;
+			blitter.blend_recode[2] = sse2_blend_recode<2>;
+			blitter.blend_colour[0] = sse2_blend_colour<0>;
+			blitter.blend_colour[1] = sse2_blend_colour<1>;
+			blitter.blend_colour[2] = sse2_blend_colour<2>;
+			blitter.alpha = sse2_alpha;
+			blitter.alpha_recode = sse2_alpha_recode;
+			break;
+
+		case BLIT_AVX2:
+			blitter.copy = avx2_copy;
+			blitter.recode = avx2_recode;
+			blitter.blend[0] = avx2_blend<0>;
+			blitter.blend[1] = avx2_blend<1>;
+			blitter.blend[2] = avx2_blend<2>;
+			blitter.blend_recode[0] = avx2_blend_recode<0>;
+			blitter.blend_recode[1] = avx2_blend_recode<1>;
+			blitter.blend_recode[2] = avx2_blend_recode<2>;
+			blitter.blend_colour[0] = avx2_blend_colour<0>;
+			blitter.blend_colour[1] = avx2_blend_colour<1>;
+			blitter.blend_colour[2] = avx2_blend_colour<2>;
+			blitter.alpha = avx2_alpha;
+			blitter.alpha_recode = avx2_alpha_recode;
+			break;
+#endif
+
+		default:
+			blitter.copy = scalar_copy;
+			blitter.recode = scalar_recode;
+			blitter.blend[0] = scalar_blend<0>;
+			blitter.blend[1] = scalar_blend<1>;
+			blitter.blend[2] = scalar_blend<2>;
+			blitter.blend_recode[0] = scalar_blend_recode<0>;
+			blitter.blend_recode[1] = scalar_blend_recode<1>;
+			blitter.blend_recode[2] = scalar_blend_recode<2>;
+			blitter.blend_colour[0] = scalar_blend_colour<0>;
+			blitter.blend_colour[1] = scalar_blend_colour<1>;
+			blitter.blend_colour[2] = scalar_blend_colour<2>;
+			blitter.alpha = scalar_alpha;
+			blitter.alpha_recode = scalar_alpha_recode;
+			break;
+	}
+	current_isa = isa;
+	return true;
+}
+
+
+void blitter_init()
+{
+	for(  int isa = BLIT_ISA_COUNT-1;  isa > BLIT_SCALAR;  isa--  ) {
+		if(  blitter_select( (blitter_isa_t)isa )  ) {
+			dbg->message( "blitter_init()", "Using %s image drawing", blitter_get_isa_name( (blitter_isa_t)isa ) );
+			return;
+		}
+	}
+	blitter_select( BLIT_SCALAR );
+}
+
+
+blitter_isa_t blitter_get_isa()
+{
+	return current_isa;
+}
+
+
+const char *blitter_get_isa_name(blitter_isa_t isa)
+{
+	switch(  isa  ) {
+		case BLIT_SCALAR: return "scalar";
+		case BLIT_SSE2:   return "SSE2";
+		case BLIT_AVX2:   return "AVX2";
+		default:          return "unknown";
+	}
+}
@@ -0,0 +1,108 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef DISPLAY_BLITTER_H
+#define DISPLAY_BLITTER_H
+
+
+#include "../simtypes.h"
+#include "../simconst.h"
+#include "../simcolor.h"
+
+
+// RGB 555/565 specific functions
+
+// different masks needed for RGB 555 and RGB 565 for blending
+#ifdef RGB555
+#define ONE_OUT (0x3DEF) // mask out bits after applying >>1
+#define TWO_OUT (0x1CE7) // mask out bits after applying >>2
+#define MASK_32 (0x03e0f81f) // mask out bits after transforming to 32bit
+inline PIXVAL rgb(PIXVAL r, PIXVAL g, PIXVAL b) { return (r << 10) | (g << 5) | b; }
+inline PIXVAL red(PIXVAL rgb) { return  rgb >> 10; }
+inline PIXVAL green(PIXVAL rgb) { return (rgb >> 5) & 0x1F; }
+#else
+#define ONE_OUT (0x7bef) // mask out bits after applying >>1
+#define TWO_OUT (0x39E7) // mask out bits after applying >>2
+#define MASK_32 (0x07e0f81f) // mask out bits after transforming to 32bit
+inline PIXVAL rgb(PIXVAL r, PIXVAL g, PIXVAL b) { return (r << 11) | (g << 5) | b; }
+inline PIXVAL red(PIXVAL rgb) { return rgb >> 11; }
+inline PIXVAL green(PIXVAL rgb) { return (rgb >> 5) & 0x3F; }
+#endif
+inline PIXVAL blue(PIXVAL rgb) { return  rgb & 0x1F; }
+
+/**
+ * Implement shift-and-mask for rgb values:
+ * shift-right by 1 or 2, and mask it to a valid rgb number.
+ */
+inline PIXVAL rgb_shr1(PIXVAL c) { return (c >> 1) & ONE_OUT; }
+inline PIXVAL rgb_shr2(PIXVAL c) { return (c >> 2) & TWO_OUT; }
+
+/// blends foreground over background, alpha 0..32
+inline PIXVAL colors_blend_alpha32(PIXVAL background, PIXVAL foreground, int alpha)
+{
+	uint32 b = ((background << 16) | background) & MASK_32;
+	uint32 f = ((foreground << 16) | foreground) & MASK_32;
+	uint32 r = ((f * alpha + (32-alpha) * b) >> 5) & MASK_32;
+	return r | (r >> 16);
+}
+
+
+/**
+ * Instruction sets the inner loops of the image drawing are available for.
+ */
+enum blitter_isa_t {
+	BLIT_SCALAR = 0,
+	BLIT_SSE2,
+	BLIT_AVX2,
+	BLIT_ISA_COUNT
+};
+
+
+/**
+ * The inner loops of the 16 bit image drawing (display_img_nc/wc, blending,
+ * alpha), working on runs of pixels. All versions give exactly the same
+ * pixels, the fastest one supported by the cpu is selected by blitter_init().
+ *
+ * Colour tables (rgbmap) must have one readable entry after the highest index
+ * used, since the AVX2 version gathers 32 bit values.
+ */
+struct blitter_procs_t
+{
+	/// copy len pixels
+	void (*copy)(PIXVAL *dest, const PIXVAL *src, uint32 len);
+
+	/// copy len pixels, converting them through the colour table
+	void (*recode)(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, uint32 len);
+
+	/// blend src with 25/50/75 percent over dest
+	void (*blend[3])(PIXVAL *dest, const PIXVAL *src, uint32 len);
+
+	/// same, but converts src through the colour table first
+	void (*blend_recode[3])(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, uint32 len);
+
+	/// blend a single colour with 25/50/75 percent over dest
+	void (*blend_colour[3])(PIXVAL *dest, PIXVAL colour, uint32 len);
+
+	/// blend src over dest, the alpha is the sum of the (15 bit) alphamap components selected by alpha_mask
+	void (*alpha)(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, PIXVAL alpha_mask, uint32 len);
+
+	/// same, but converts src through the colour table first
+	void (*alpha_recode)(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, const PIXVAL *alphamap, PIXVAL alpha_mask, uint32 len);
+};
+
+/// the currently selected inner loops
+extern blitter_procs_t blitter;
+
+/// selects the best instruction set supported by this cpu
+void blitter_init();
+
+/// @returns false (and changes nothing) if the cpu or this build does not support @p isa
+bool blitter_select(blitter_isa_t isa);
+
+blitter_isa_t blitter_get_isa();
+
+const char *blitter_get_isa_name(blitter_isa_t isa);
+
+#endif
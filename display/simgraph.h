@@ -169,6 +169,9 @@ bool display_load_font(const char *fname, bool reload = false);
 image_id get_image_count();
 void register_image(class image_t *);
 
+/// draws all images with every blitter the cpu supports and prints the times
+void display_benchmark_blitters(uint32 rounds);
+
 // delete all images above a certain number ...
 void display_free_all_images_above( image_id above );
 
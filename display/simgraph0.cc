@@ -489,6 +489,10 @@ image_id get_image_count()
 	return 0;
 }
 
+void display_benchmark_blitters(uint32)
+{
+}
+
 #ifdef MULTI_THREAD
 void add_poly_clip(int, int, int, int, int  CLIP_NUM_DEF_NOUSE)
 {
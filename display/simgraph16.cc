@@ -30,6 +30,7 @@
 #include "../dataobj/environment.h"
 
 #include "simgraph.h"
+#include "blitter.h"
 #include "../descriptor/vehicle_desc.h"
 #include "../gui/simwin.h"
 #include "../gui/gui_theme.h"
@@ -49,7 +50,11 @@
 
 // currently just redrawing/rezooming
 static pthread_mutex_t rezoom_img_mutex[MAX_THREADS];
-static pthread_mutex_t recode_img_mutex;
+
+// recoding locks only the image (striped by image id), so the drawing threads
+// only wait for each other when they need the very same image
+#define RECODE_IMG_MUTEX_COUNT (64)
+static pthread_mutex_t recode_img_mutex[RECODE_IMG_MUTEX_COUNT];
 #endif
 
 // to pass the extra clipnum when not needed use this
@@ -258,34 +263,6 @@ int default_font_linespace = 0;
 
 #define RGBMAPSIZE (0x8000+LIGHT_COUNT+MAX_PLAYER_COUNT+1024 /* 343 transparent */)
 
-// RGB 555/565 specific functions
-
-// different masks needed for RGB 555 and RGB 565 for blending
-#ifdef RGB555
-#define ONE_OUT (0x3DEF) // mask out bits after applying >>1
-#define TWO_OUT (0x1CE7) // mask out bits after applying >>2
-#define MASK_32 (0x03e0f81f) // mask out bits after transforming to 32bit
-inline PIXVAL rgb(PIXVAL r, PIXVAL g, PIXVAL b) { return (r << 10) | (g << 5) | b; }
-inline PIXVAL red(PIXVAL rgb) { return  rgb >> 10; }
-inline PIXVAL green(PIXVAL rgb) { return (rgb >> 5) & 0x1F; }
-#else
-#define ONE_OUT (0x7bef) // mask out bits after applying >>1
-#define TWO_OUT (0x39E7) // mask out bits after applying >>2
-#define MASK_32 (0x07e0f81f) // mask out bits after transforming to 32bit
-inline PIXVAL rgb(PIXVAL r, PIXVAL g, PIXVAL b) { return (r << 11) | (g << 5) | b; }
-inline PIXVAL red(PIXVAL rgb) { return rgb >> 11; }
-inline PIXVAL green(PIXVAL rgb) { return (rgb >> 5) & 0x3F; }
-#endif
-inline PIXVAL blue(PIXVAL rgb) { return  rgb & 0x1F; }
-
-/**
- * Implement shift-and-mask for rgb values:
- * shift-right by 1 or 2, and mask it to a valid rgb number.
- */
-inline PIXVAL rgb_shr1(PIXVAL c) { return (c >> 1) & ONE_OUT; }
-inline PIXVAL rgb_shr2(PIXVAL c) { return (c >> 2) & TWO_OUT; }
-
-
 /*
  * mapping tables for RGB 555 to actual output format
  * plus the special (player, day&night) colors appended
@@ -296,13 +273,13 @@ inline PIXVAL rgb_shr2(PIXVAL c) { return (c >> 2) & TWO_OUT; }
  * The following transparent colors are not in the colortable
  * 0x8020 - 0xFFE1: 3 4 3 RGB transparent colors in 31 transparency levels
  */
-static PIXVAL rgbmap_day_night[RGBMAPSIZE];
+static PIXVAL rgbmap_day_night[RGBMAPSIZE+1]; // one more for the AVX2 blitter, see blitter_procs_t
 
 
 /*
  * same as rgbmap_day_night, but always daytime colors
  */
-static PIXVAL rgbmap_all_day[RGBMAPSIZE];
+static PIXVAL rgbmap_all_day[RGBMAPSIZE+1];
 
 
 /*
@@ -354,6 +331,8 @@ struct imd {
 	sint16 base_h; // height
 
 	PIXVAL* base_data; // original image data
+
+	uint32 last_used; // image_frame when last drawn (to free the cached copies of unused images first)
 };
 
 // Flags for recoding
@@ -387,6 +366,11 @@ static struct imd* images = NULL;
  */
 static image_id anz_images = 0;
 
+/*
+ * Counts the flushed frames, for images[].last_used
+ */
+static uint32 image_frame = 0;
+
 /*
  * Number of allocated entries for images
  * (>= anz_images)
@@ -1065,8 +1049,9 @@ static void recode()
 
 /**
  * Convert a certain image data to actual output data
+ * @param player_colors the 16 player colours (first and second company colour) to use instead of rgbmap_day_night[0x8000..0x800F]
  */
-static void recode_img_src_target(scr_coord_val h, PIXVAL *src, PIXVAL *target)
+static void recode_img_src_target(scr_coord_val h, PIXVAL *src, PIXVAL *target, const PIXVAL *player_colors)
 {
 	if(  h > 0  ) {
 		do {
@@ -1081,7 +1066,7 @@ static void recode_img_src_target(scr_coord_val h, PIXVAL *src, PIXVAL *target)
 						if(  *src < 0x8020+(31*16)  ) {
 							// expand transparent player color
 							const uint8 alpha   = (*src-0x8020) % 31;
-							const PIXVAL colour = rgbmap_day_night[(*src-0x8020)/31+0x8000];
+							const PIXVAL colour = player_colors[(*src-0x8020)/31];
 
 							*target++ = 0x8020 + 31*31 + pixval_to_rgb343(colour)*31 + alpha;
 							src ++;
@@ -1094,7 +1079,8 @@ static void recode_img_src_target(scr_coord_val h, PIXVAL *src, PIXVAL *target)
 				else {
 					// now just convert the color pixels
 					while(  runlen--  ) {
-						*target++ = rgbmap_day_night[*src++];
+						const PIXVAL pix = *src++;
+						*target++ = (pix & 0xFFF0) == 0x8000 ? player_colors[pix - 0x8000] : rgbmap_day_night[pix];
 					}
 				}
 				// next clear run or zero = end
@@ -1117,10 +1103,10 @@ static void recode_img(const image_id n, const sint8 player_nr)
 {
 	// may this image be zoomed
 #ifdef MULTI_THREAD
-	pthread_mutex_lock( &recode_img_mutex );
+	pthread_mutex_lock( &recode_img_mutex[n % RECODE_IMG_MUTEX_COUNT] );
 	if(  (images[n].player_flags & (1<<player_nr)) == 0  ) {
 		// other thread did already the re-code...
-		pthread_mutex_unlock( &recode_img_mutex );
+		pthread_mutex_unlock( &recode_img_mutex[n % RECODE_IMG_MUTEX_COUNT] );
 		return;
 	}
 #endif
@@ -1129,12 +1115,16 @@ static void recode_img(const image_id n, const sint8 player_nr)
 	if(  images[n].data[player_nr] == NULL  ) {
 		images[n].data[player_nr] = MALLOCN( PIXVAL, images[n].len );
 	}
-	// contains now the player color ...
-	activate_player_color( player_nr, true );
-	recode_img_src_target( images[n].h, src, images[n].data[player_nr] );
+	// the player colours are looked up locally instead of patching the shared rgbmap_day_night (see activate_player_color)
+	PIXVAL player_colors[16];
+	for(  int i = 0;  i < 8;  i++  ) {
+		player_colors[i]   = specialcolormap_day_night[player_offsets[player_nr][0]+i];
+		player_colors[8+i] = specialcolormap_day_night[player_offsets[player_nr][1]+i];
+	}
+	recode_img_src_target( images[n].h, src, images[n].data[player_nr], player_colors );
 	images[n].player_flags &= ~(1<<player_nr);
 #ifdef MULTI_THREAD
-	pthread_mutex_unlock( &recode_img_mutex );
+	pthread_mutex_unlock( &recode_img_mutex[n % RECODE_IMG_MUTEX_COUNT] );
 #endif
 }
 
@@ -1910,12 +1900,78 @@ void register_image(image_t *image_in)
 
 	// since we do not recode them, we can work with the original data
 	image->base_data = image_in->data;
+	image->last_used = image_frame;
 
 	// now find out, it contains player colors
 
 }
 
 
+// frees the zoomed and recoloured copies of an image; they are recreated when drawn again
+static size_t free_image_copies( const image_id n )
+{
+	size_t freed = 0;
+	if(  images[n].zoom_data != NULL  ) {
+		free( images[n].zoom_data );
+		images[n].zoom_data = NULL;
+		images[n].recode_flags |= FLAG_REZOOM;
+		freed += images[n].len;
+	}
+	for(  uint8 i = 0;  i < MAX_PLAYER_COUNT;  i++  ) {
+		if(  images[n].data[i] != NULL  ) {
+			free( images[n].data[i] );
+			images[n].data[i] = NULL;
+			freed += images[n].len;
+		}
+	}
+	images[n].player_flags = 0xFFFF;
+	return freed * sizeof(PIXVAL);
+}
+
+
+/**
+ * Keeps the memory of the zoomed and recoloured copies below env_t::image_cache_mb
+ * by freeing those of the images not drawn for the longest time.
+ * Must not be called while drawing, hence it runs when the frame is flushed.
+ */
+static void limit_image_cache()
+{
+	// called after drawing: the images of this frame still have age 0 until the end
+	const uint32 frame = image_frame++;
+	if(  env_t::image_cache_mb == 0  ||  (frame & 63) != 0  ) {
+		return;
+	}
+
+	const size_t budget = (size_t)env_t::image_cache_mb << 20;
+	size_t used = 0;
+	vector_tpl<std::pair<uint32, image_id> > lru;
+	for(  image_id n = 0;  n < anz_images;  n++  ) {
+		uint32 copies = images[n].zoom_data != NULL;
+		for(  uint8 i = 0;  i < MAX_PLAYER_COUNT;  i++  ) {
+			copies += images[n].data[i] != NULL;
+		}
+		if(  copies  ) {
+			used += (size_t)copies * images[n].len * sizeof(PIXVAL);
+			// how many frames ago, so wrapping of image_frame does no harm
+			lru.append( std::make_pair( frame - images[n].last_used, n ) );
+		}
+	}
+	if(  used <= budget  ) {
+		return;
+	}
+
+	// free down to 3/4 of the budget, so this is not needed again right away
+	std::sort( lru.begin(), lru.end() );
+	const size_t target = budget - budget / 4;
+	for(  uint32 i = lru.get_count();  i-- > 0  &&  used > target;  ) {
+		if(  lru[i].first == 0  ) {
+			break; // still on screen
+		}
+		used -= free_image_copies( lru[i].second );
+	}
+}
+
+
 // delete all images above a certain number ...
 // (mostly needed when changing climate zones)
 void display_free_all_images_above( image_id above )
@@ -1959,18 +2015,12 @@ void display_get_base_image_offset(image_id image, scr_coord_val *xoff, scr_coor
 
 // ------------------ display all kind of images from here on ------------------------------
 
-// forward declaration, implementation is further below
-PIXVAL colors_blend_alpha32(PIXVAL background, PIXVAL foreground, int alpha);
-
 /**
  * Copy Pixel from src to dest
  */
 static inline void pixcopy(PIXVAL *dest, const PIXVAL *src, const PIXVAL * const end)
 {
-	// for gcc this seems to produce the optimal code ...
-	while (src < end) {
-		*dest++ = *src++;
-	}
+	blitter.copy( dest, src, end - src );
 }
 
 
@@ -1980,9 +2030,7 @@ static inline void pixcopy(PIXVAL *dest, const PIXVAL *src, const PIXVAL * const
 static inline void colorpixcopy(PIXVAL* dest, const PIXVAL* src, const PIXVAL* const end)
 {
 	if (*src < 0x8020) {
-		while (src < end) {
-			*dest++ = rgbmap_current[*src++];
-		}
+		blitter.recode( dest, src, rgbmap_current, end - src );
 	}
 	else {
 		while (src < end) {
@@ -2003,9 +2051,7 @@ static inline void colorpixcopy(PIXVAL* dest, const PIXVAL* src, const PIXVAL* c
 static inline void colorpixcopydaytime(PIXVAL* dest, const PIXVAL* src, const PIXVAL* const end)
 {
 	if (*src < 0x8020) {
-		while (src < end) {
-			*dest++ = rgbmap_current[*src++];
-		}
+		blitter.recode( dest, src, rgbmap_current, end - src );
 	}
 	else {
 		while (src < end) {
@@ -2174,46 +2220,9 @@ static void display_img_nc(scr_coord_val h, const scr_coord_val xp, const scr_co
 					sp += runlen;
 				}
 				else {
-#ifdef LOW_LEVEL
-#ifdef SIM_BIG_ENDIAN
-					// low level c++ without any unrolling
-					while(  runlen--  ) {
-						*p++ = *sp++;
-					}
-#else
-					// trying to merge reads and writes
-					if(  runlen  ) {
-						// align to 4 bytes, should use uintptr_t but not available
-						if(  reinterpret_cast<size_t>(p) & 0x2  ) {
-							*p++ = *sp++;
-							runlen--;
-						}
-						// aligned fast copy loop
-						bool const postalign = runlen & 1;
-						runlen >>= 1;
-						uint32 *ld = (uint32 *)p;
-						while (runlen--) {
-#if defined _MSC_VER // MSVC can read unaligned
-							*ld++ = *(uint32 const *const)sp;
-#else
-							// little endian order, assumed by default
-							*ld++ = (uint32(sp[1]) << 16) | uint32(sp[0]);
-#endif
-							sp += 2;
-						}
-						p = (PIXVAL*)ld;
-						// finish unaligned remainder
-						if(  postalign  ) {
-							*p++ = *sp++;
-						}
-					}
-#endif
-#else
-					// high level c++
-					const PIXVAL *const splast = sp + runlen;
-					p = std::copy(sp, splast, p);
-					sp = splast;
-#endif
+					blitter.copy( p, sp, runlen );
+					p += runlen;
+					sp += runlen;
 				}
 				runlen = *sp++;
 			} while (runlen != 0);
@@ -2261,6 +2270,7 @@ void display_img_aligned( const image_id n, scr_rect area, int align, const bool
 void display_img_aux(const image_id n, scr_coord_val xp, scr_coord_val yp, const sint8 player_nr_raw, const bool /*daynight*/, const bool dirty  CLIP_NUM_DEF)
 {
 	if(  n < anz_images  ) {
+		images[n].last_used = image_frame;
 		// only use player images if needed
 		const sint8 use_player = (images[n].recode_flags & FLAG_HAS_PLAYER_COLOR) * player_nr_raw;
 		// need to go to nightmode and or re-zoomed?
@@ -2609,6 +2619,8 @@ void display_color_img(const image_id n, scr_coord_val xp, scr_coord_val yp, sin
 			return;
 		}
 		else {
+			// zoom_data is read below, so it must not be evicted as unused
+			images[n].last_used = image_frame;
 		// do player colour substitution but not daynight - can't use cached images. Do NOT call multithreaded.
 		// now test if visible and clipping needed
 			const scr_coord_val x = images[n].x + xp;
@@ -2733,13 +2745,6 @@ void display_base_img(const image_id n, scr_coord_val xp, scr_coord_val yp, cons
 inline PIXVAL colors_blend25(PIXVAL background, PIXVAL foreground) { return rgb_shr1(background) + rgb_shr2(background) + rgb_shr2(foreground); }
 inline PIXVAL colors_blend50(PIXVAL background, PIXVAL foreground) { return rgb_shr1(background) + rgb_shr1(foreground); }
 inline PIXVAL colors_blend75(PIXVAL background, PIXVAL foreground) { return rgb_shr2(background) + rgb_shr1(foreground) + rgb_shr2(foreground); }
-inline PIXVAL colors_blend_alpha32(PIXVAL background, PIXVAL foreground, int alpha)
-{
-	uint32 b = ((background << 16) | background) & MASK_32;
-	uint32 f = ((foreground << 16) | foreground) & MASK_32;
-	uint32 r = ((f * alpha + (32-alpha) * b) >> 5) & MASK_32;
-	return r | (r >> 16);
-}
 
 // Blends two colors. Possible values for alpha: 0..32
 PIXVAL display_blend_colors_alpha32(PIXVAL background, PIXVAL foreground, int alpha)
@@ -2772,56 +2777,38 @@ PIXVAL display_blend_colors(PIXVAL background, PIXVAL foreground, int percent_bl
 /* from here code for transparent images */
 typedef void (*blend_proc)(PIXVAL *dest, const PIXVAL *src, const PIXVAL colour, const PIXVAL len);
 
-// templated structures to specialize for the different blend modes: 25/50/75 percent
-struct blend25_t { static inline PIXVAL blend(PIXVAL background, PIXVAL foreground) { return 3 * rgb_shr2(background) + rgb_shr2(foreground); } };
-struct blend50_t { static inline PIXVAL blend(PIXVAL background, PIXVAL foreground) { return rgb_shr1(background) + rgb_shr1(foreground); }     };
-struct blend75_t { static inline PIXVAL blend(PIXVAL background, PIXVAL foreground) { return rgb_shr2(background) + 3 * rgb_shr2(foreground); } };
-
-template<class F> void pix_blend_tpl(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
+// the blend modes 25/50/75 percent are the blitter procs 0..2
+template<int mode> void pix_blend_tpl(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
 {
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = F::blend(*dest, *src);
-		dest++;
-		src++;
-	}
+	blitter.blend[mode]( dest, src, len );
 }
 
-// the following 6 functions are for display_base_img_blend()
-template<class F> void pix_blend_recode_tpl(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
+// these are for display_base_img_blend()
+template<int mode> void pix_blend_recode_tpl(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
 {
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = F::blend(*dest, rgbmap_current[*src]);
-		dest++;
-		src++;
-	}
+	blitter.blend_recode[mode]( dest, src, rgbmap_current, len );
 }
 
-template<class F> void pix_outline_tpl(PIXVAL *dest, const PIXVAL *, const PIXVAL colour, const PIXVAL len)
+template<int mode> void pix_outline_tpl(PIXVAL *dest, const PIXVAL *, const PIXVAL colour, const PIXVAL len)
 {
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = F::blend(*dest, colour);
-		dest++;
-	}
+	blitter.blend_colour[mode]( dest, colour, len );
 }
 
 // save them for easier access
 static blend_proc blend[3] = {
-	pix_blend_tpl<blend25_t>,
-	pix_blend_tpl<blend50_t>,
-	pix_blend_tpl<blend75_t> };
+	pix_blend_tpl<0>,
+	pix_blend_tpl<1>,
+	pix_blend_tpl<2> };
 
 static blend_proc blend_recode[3] = {
-	pix_blend_recode_tpl<blend25_t>,
-	pix_blend_recode_tpl<blend50_t>,
-	pix_blend_recode_tpl<blend75_t>};
+	pix_blend_recode_tpl<0>,
+	pix_blend_recode_tpl<1>,
+	pix_blend_recode_tpl<2>};
 
 static blend_proc outline[3] = {
-	pix_outline_tpl<blend25_t>,
-	pix_outline_tpl<blend50_t>,
-	pix_outline_tpl<blend75_t>};
+	pix_outline_tpl<0>,
+	pix_outline_tpl<1>,
+	pix_outline_tpl<2>};
 
 
 /**
@@ -2951,53 +2938,13 @@ typedef void (*alpha_proc)(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alpham
 
 static void alpha(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const PIXVAL alpha_mask, const PIXVAL , const PIXVAL len)
 {
-	const PIXVAL *const end = dest + len;
-
-	while(  dest < end  ) {
-		// read mask components - always 15bpp
-		uint16 masked = *alphamap & alpha_mask;
-		uint16 alpha_value = (masked & 0x1f) + ((masked >> 5) & 0x1f) + ((masked >> 10) & 0x1f);
-
-		if(  alpha_value > 30  ) {
-			// opaque, just copy source
-			*dest = *src;
-		}
-		else if(  alpha_value > 0  ) {
-			alpha_value = alpha_value > 15 ? alpha_value + 1 : alpha_value;
-
-			*dest = colors_blend_alpha32(*dest, *src, alpha_value);
-		}
-
-		dest++;
-		src++;
-		alphamap++;
-	}
+	blitter.alpha( dest, src, alphamap, alpha_mask, len );
 }
 
 
 static void alpha_recode(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const PIXVAL alpha_mask, const PIXVAL , const PIXVAL len)
 {
-	const PIXVAL *const end = dest + len;
-
-	while(  dest < end  ) {
-		// read mask components - always 15bpp
-		uint16 masked = *alphamap & alpha_mask;
-		uint16 alpha_value = (masked & 0x1f) + ((masked >> 5) & 0x1f) + ((masked >> 10) & 0x1f);
-
-		if(  alpha_value > 30  ) {
-			// opaque, just copy source
-			*dest = rgbmap_current[*src];
-		}
-		else if(  alpha_value > 0  ) {
-			alpha_value = alpha_value > 15 ? alpha_value + 1 : alpha_value;
-
-			*dest = colors_blend_alpha32(*dest, rgbmap_current[*src], alpha_value);
-		}
-
-		dest++;
-		src++;
-		alphamap++;
-	}
+	blitter.alpha_recode( dest, src, rgbmap_current, alphamap, alpha_mask, len );
 }
 
 
@@ -3046,6 +2993,7 @@ static void display_img_alpha_wc(scr_coord_val h, const scr_coord_val xp, const
 void display_rezoomed_img_blend(const image_id n, scr_coord_val xp, scr_coord_val yp, const signed char /*player_nr*/, const FLAGGED_PIXVAL color_index, const bool /*daynight*/, const bool dirty  CLIP_NUM_DEF)
 {
 	if(  n < anz_images  ) {
+		images[n].last_used = image_frame;
 		// need to go to nightmode and or rezoomed?
 		if(  (images[n].recode_flags & FLAG_REZOOM)  ) {
 			rezoom_img( n );
@@ -3117,6 +3065,8 @@ void display_rezoomed_img_blend(const image_id n, scr_coord_val xp, scr_coord_va
 void display_rezoomed_img_alpha(const image_id n, const image_id alpha_n, const unsigned alpha_flags, scr_coord_val xp, scr_coord_val yp, const sint8 /*player_nr*/, const FLAGGED_PIXVAL color_index, const bool /*daynight*/, const bool dirty  CLIP_NUM_DEF)
 {
 	if(  n < anz_images  &&  alpha_n < anz_images  ) {
+		images[n].last_used = image_frame;
+		images[alpha_n].last_used = image_frame;
 		// need to go to nightmode and or rezoomed?
 		if(  (images[n].recode_flags & FLAG_REZOOM)  ) {
 			rezoom_img( n );
@@ -3341,6 +3291,72 @@ void display_base_img_alpha(const image_id n, const image_id alpha_n, const unsi
 }
 
 
+/**
+ * Draws all images of the pakset with each blitter this cpu supports, as
+ * plain images, blended, as outline and with alpha, partly clipped at the
+ * screen border. Prints the time per kind of drawing and checks that all
+ * blitters gave the same screen.
+ */
+void display_benchmark_blitters(uint32 rounds)
+{
+	if(  anz_images == 0  ||  rounds == 0  ) {
+		return;
+	}
+	const char *const kind_names[4] = { "images", "blend", "outline", "alpha" };
+	const blitter_isa_t old_isa = blitter_get_isa();
+	const uint32 pixels = disp_width * disp_height;
+
+	// recode and rezoom everything beforehand, so only drawing is measured
+	for(  image_id n = 0;  n < anz_images;  n++  ) {
+		display_color_img( n, 0, 0, 0, true, false );
+		display_img_blend( n, 0, 0, TRANSPARENT50_FLAG | color_idx_to_rgb(COL_WHITE), true, false );
+	}
+
+	printf( "Drawing %u images %u times on %ix%i pixels\n", anz_images, rounds, disp_width, disp_height );
+	printf( "%-8s %10s %10s %10s %10s\n", "blitter", kind_names[0], kind_names[1], kind_names[2], kind_names[3] );
+
+	uint32 first_hash = 0;
+	for(  int isa = BLIT_SCALAR;  isa < BLIT_ISA_COUNT;  isa++  ) {
+		if(  !blitter_select( (blitter_isa_t)isa )  ) {
+			continue;
+		}
+		display_fillbox_wh_rgb( 0, 0, disp_width, disp_height, 0, false );
+
+		printf( "%-8s", blitter_get_isa_name( (blitter_isa_t)isa ) );
+		for(  int kind = 0;  kind < 4;  kind++  ) {
+			const uint64 start = dr_time_us();
+			for(  uint32 round = 0;  round < rounds;  round++  ) {
+				for(  image_id n = 0;  n < anz_images;  n++  ) {
+					// spread over the screen, some images are clipped at the left and top border
+					const scr_coord_val x = (scr_coord_val)((n * 97u + round * 13u) % (uint32)(disp_width + 64)) - 64;
+					const scr_coord_val y = (scr_coord_val)((n * 53u + round * 7u) % (uint32)(disp_height + 64)) - 64;
+					switch(  kind  ) {
+						case 0: display_color_img( n, x, y, 0, true, false ); break;
+						case 1: display_img_blend( n, x, y, TRANSPARENT25_FLAG | color_idx_to_rgb(COL_WHITE), true, false ); break;
+						case 2: display_img_blend( n, x, y, TRANSPARENT75_FLAG | OUTLINE_FLAG | color_idx_to_rgb(COL_RED), true, false ); break;
+						case 3: display_img_alpha( n, n, ALPHA_RED | ALPHA_GREEN | ALPHA_BLUE, x, y, 0, true, false ); break;
+					}
+				}
+			}
+			printf( " %8.1fms", (dr_time_us() - start) / 1000.0 );
+		}
+
+		// FNV-1a over the screen
+		uint32 hash = 2166136261u;
+		for(  uint32 i = 0;  i < pixels;  i++  ) {
+			hash = (hash ^ textur[i]) * 16777619u;
+		}
+		if(  isa == BLIT_SCALAR  ) {
+			first_hash = hash;
+		}
+		printf( "  %s\n", hash == first_hash ? "ok" : "DIFFERENT SCREEN" );
+	}
+
+	blitter_select( old_isa );
+	mark_screen_dirty();
+}
+
+
 // ----------------- basic painting procedures ----------------
 
 
@@ -4952,6 +4968,8 @@ void display_flush_buffer()
 	uint32 *tmp = tile_dirty_old;
 	tile_dirty_old = tile_dirty;
 	tile_dirty = tmp; // _old was cleared to 0 in above loops
+
+	limit_image_cache();
 }
 
 
@@ -4998,8 +5016,12 @@ bool simgraph_init(scr_size window_size, sint16 full_screen)
 	disp_actual_width = window_size.w;
 	disp_height = window_size.h;
 
+	blitter_init();
+
 #ifdef MULTI_THREAD
-	pthread_mutex_init( &recode_img_mutex, NULL );
+	for(  int i = 0;  i < RECODE_IMG_MUTEX_COUNT;  i++  ) {
+		pthread_mutex_init( &recode_img_mutex[i], NULL );
+	}
 #endif
 
 	// init rezoom_img()
@@ -5106,7 +5128,9 @@ void simgraph_exit()
 	tile_dirty = tile_dirty_old = NULL;
 	images = NULL;
 #ifdef MULTI_THREAD
-	pthread_mutex_destroy( &recode_img_mutex );
+	for(  int i = 0;  i < RECODE_IMG_MUTEX_COUNT;  i++  ) {
+		pthread_mutex_destroy( &recode_img_mutex[i] );
+	}
 	for(  int i = 0;  i < MAX_THREADS;  i++  ) {
 		pthread_mutex_destroy( &rezoom_img_mutex[i] );
 	}
@@ -20,6 +20,7 @@
 #include "../descriptor/ground_desc.h"
 #include "../boden/wasser.h"
 #include "../dataobj/environment.h"
+#include "../dataobj/objlist.h"
 #include "../obj/zeiger.h"
 #include "../utils/simrandom.h"
 
@@ -126,6 +127,7 @@ void main_view_t::display(bool force_dirty)
 	// redraw everything?
 	force_dirty = force_dirty || welt->is_dirty();
 	welt->unset_dirty();
+	objlist_t::prepare_draw_lists( force_dirty );
 	if(  force_dirty  ) {
 		mark_screen_dirty();
 		welt->set_background_dirty();
@@ -294,6 +296,8 @@ void main_view_t::display(bool force_dirty)
 		}
 	}
 
+	objlist_t::finish_draw_lists();
+
 	obj_t *zeiger = welt->get_zeiger();
 	DBG_DEBUG4("main_view_t::display", "display pointer");
 	if( zeiger  &&  zeiger->get_pos() != koord3d::invalid ) {
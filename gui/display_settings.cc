@@ -23,6 +23,7 @@
 #include "gui_theme.h"
 #include "themeselector.h"
 #include "loadfont_frame.h"
+#include "step_profiler_frame.h"
 #include "simwin.h"
 
 #include "../path_explorer.h"
@@ -307,6 +308,11 @@ gui_settings_t::gui_settings_t()
 		add_component(&cities_to_process_label);
 	}
 	end_table();
+
+	step_profile.init(button_t::roundbox, "Step profile");
+	step_profile.set_tooltip("Shows the time spent in the phases of the last steps.");
+	step_profile.add_listener(this);
+	add_component(&step_profile);
 }
 
 void gui_settings_t::draw(scr_coord offset)
@@ -391,6 +397,9 @@ bool gui_settings_t::action_triggered(gui_action_creator_t *comp, value_t)
 		dr_set_screen_scale(-1);
 		screen_scale_numinp.set_value(dr_get_screen_scale());
 	}
+	else if (comp == &step_profile) {
+		create_win(new step_profiler_frame_t(), w_info, magic_step_profiler);
+	}
 
 	return true;
 }
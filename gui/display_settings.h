@@ -25,6 +25,7 @@ class gui_settings_t : public gui_aligned_container_t, public action_listener_t
 private:
 	gui_numberinput_t screen_scale_numinp;
 	button_t screen_scale_auto;
+	button_t step_profile;
 
 	gui_label_buf_t
 		frame_time_value_label,
@@ -788,6 +788,7 @@ void halt_info_t::init(halthandle_t halt)
 
 	chart.set_min_size(scr_size(0, CHART_HEIGHT));
 	chart.set_dimension(12, 10000);
+	halt->get_finance_history(*chart_history);
 	chart.set_background(SYSCOL_CHART_BACKGROUND);
 	container_chart.add_component(&chart);
 
@@ -796,7 +797,7 @@ void halt_info_t::init(halthandle_t halt)
 		const uint8 precision = index_of_haltinfo[cost]== HALT_GOODS_HANDLING_VOLUME ? 2 : 0;
 		const gui_chart_t::chart_marker_t marker_type = chart_freight_type[cost]==halt_info_t::ft_pax ? gui_chart_t::round_box
 			: chart_freight_type[cost]==halt_info_t::ft_mail ? gui_chart_t::square : chart_freight_type[cost] == halt_info_t::ft_goods ? gui_chart_t::diamond : gui_chart_t::cross;
-		uint16 curve = chart.add_curve(color_idx_to_rgb(cost_type_color[cost]), halt->get_finance_history(), MAX_HALT_COST,
+		uint16 curve = chart.add_curve(color_idx_to_rgb(cost_type_color[cost]), *chart_history, MAX_HALT_COST,
 			index_of_haltinfo[cost], MAX_MONTHS, index_of_haltinfo[cost]==HALT_GOODS_HANDLING_VOLUME ? gui_chart_t::TONNEN : 0, false, true, precision, 0, marker_type);
 
 		button_t *b = container_chart.new_component<button_t>();
@@ -1051,6 +1052,7 @@ void halt_info_t::activate_chart_buttons()
 void halt_info_t::update_components()
 {
 	indicator_color.set_color(halt->get_status_farbe());
+	halt->get_finance_history(*chart_history);
 
 	// update evaluation
 	if (halt->get_pax_enabled() || halt->get_mail_enabled()) {
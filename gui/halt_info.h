@@ -215,6 +215,7 @@ private:
 
 	gui_textinput_t input;
 	gui_chart_t chart;
+	sint64 chart_history[MAX_MONTHS][MAX_HALT_COST]; ///< copy of the halt history drawn by chart
 	location_view_t view;
 	button_t detail_button;
 
@@ -161,7 +161,10 @@ static const char *revision_ex[] =
 	"64",
 	"65",
 	"66",
-	"67"
+	"67",
+	"68",
+	"69",
+	"70"
 };
 
 
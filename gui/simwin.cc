@@ -774,6 +774,14 @@ int create_win(scr_coord pos, gui_frame_t *const gui, wintype const wt, ptrdiff_
 {
 	assert(gui!=NULL  &&  magic!=0);
 
+#if COLOUR_DEPTH == 0
+	// without display nobody will ever see (or close) an anonymous window
+	if(  magic == magic_none  &&  !( wt & w_do_not_delete )  ) {
+		delete gui;
+		return -1;
+	}
+#endif
+
 	if(  gui_frame_t *win = win_get_magic(magic)  ) {
 		if(  env_t::second_open_closes_win  ) {
 			destroy_win( win );
@@ -136,6 +136,7 @@ enum magic_numbers {
 	magic_replace_line,
 	magic_consist_order,
 	magic_script_error,
+	magic_step_profiler,
 	magic_max
 };
 
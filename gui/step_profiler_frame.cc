@@ -0,0 +1,83 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include "step_profiler_frame.h"
+#include "components/gui_divider.h"
+
+#include "../dataobj/translator.h"
+
+
+step_profiler_frame_t::step_profiler_frame_t() :
+	gui_frame_t( translator::translate("Step profile") )
+{
+	set_table_layout(1,0);
+
+	add_component(&steps_label);
+	new_component<gui_divider_t>();
+
+	add_table(1+COLUMNS,0);
+	{
+		// header: statistics in ms, then the upper limits of the histogram buckets
+		new_component<gui_label_t>("Phase");
+		new_component<gui_label_t>("last", SYSCOL_TEXT, gui_label_t::right);
+		new_component<gui_label_t>("mean", SYSCOL_TEXT, gui_label_t::right);
+		new_component<gui_label_t>("95%", SYSCOL_TEXT, gui_label_t::right);
+		new_component<gui_label_t>("max", SYSCOL_TEXT, gui_label_t::right);
+		for(  uint32 b = 0;  b < step_profiler_t::HISTOGRAM_BUCKETS;  b++  ) {
+			gui_label_buf_t *lb = new_component<gui_label_buf_t>(SYSCOL_TEXT, gui_label_t::right);
+			if(  b+1 < step_profiler_t::HISTOGRAM_BUCKETS  ) {
+				lb->buf().printf( "<%g", step_profiler_t::get_bucket_limit(b+1) / 1000.0 );
+			}
+			else {
+				lb->buf().printf( ">=%g", step_profiler_t::get_bucket_limit(b) / 1000.0 );
+			}
+			lb->update();
+		}
+
+		for(  int p = 0;  p < step_profiler_t::MAX_PHASES;  p++  ) {
+			new_component<gui_label_t>( step_profiler_t::get_name((step_profiler_t::phase_t)p) );
+			for(  int c = 0;  c < COLUMNS;  c++  ) {
+				values[p][c].init( SYSCOL_TEXT, gui_label_t::right );
+				values[p][c].buf().printf( "9999.9" );
+				values[p][c].update();
+				add_component( &values[p][c] );
+			}
+		}
+	}
+	end_table();
+
+	steps_label.buf().printf( "%s", translator::translate("Times in ms") );
+	steps_label.update();
+
+	reset_min_windowsize();
+	set_windowsize(get_min_windowsize());
+}
+
+
+void step_profiler_frame_t::draw(scr_coord pos, scr_size size)
+{
+	steps_label.buf().printf( translator::translate("Times in ms over the last %u steps"), step_profiler_t::get_history_count() );
+	steps_label.update();
+
+	for(  int p = 0;  p < step_profiler_t::MAX_PHASES;  p++  ) {
+		const step_profiler_t::phase_t phase = (step_profiler_t::phase_t)p;
+		uint32 stats[STATISTICS];
+		stats[0] = step_profiler_t::get_last( phase );
+		step_profiler_t::get_statistics( phase, stats[1], stats[2], stats[3] );
+		for(  int c = 0;  c < STATISTICS;  c++  ) {
+			values[p][c].buf().printf( "%.1f", stats[c] / 1000.0 );
+			values[p][c].update();
+		}
+
+		uint32 buckets[step_profiler_t::HISTOGRAM_BUCKETS];
+		step_profiler_t::get_histogram( phase, buckets );
+		for(  uint32 b = 0;  b < step_profiler_t::HISTOGRAM_BUCKETS;  b++  ) {
+			values[p][STATISTICS+b].buf().printf( "%u", buckets[b] );
+			values[p][STATISTICS+b].update();
+		}
+	}
+
+	gui_frame_t::draw(pos, size);
+}
@@ -0,0 +1,32 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef GUI_STEP_PROFILER_FRAME_H
+#define GUI_STEP_PROFILER_FRAME_H
+
+
+#include "gui_frame.h"
+#include "components/gui_label.h"
+#include "../utils/step_profiler.h"
+
+
+/**
+ * Shows the time spent in the phases of the last steps
+ * (see step_profiler_t), with a histogram over the last steps.
+ */
+class step_profiler_frame_t : public gui_frame_t
+{
+	enum { STATISTICS = 4, COLUMNS = STATISTICS + step_profiler_t::HISTOGRAM_BUCKETS };
+
+	gui_label_buf_t steps_label;
+	gui_label_buf_t values[step_profiler_t::MAX_PHASES][COLUMNS];
+
+public:
+	step_profiler_frame_t();
+
+	void draw(scr_coord pos, scr_size size) OVERRIDE;
+};
+
+#endif
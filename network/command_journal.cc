@@ -0,0 +1,244 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include "command_journal.h"
+
+#include "network_cmd_ingame.h"
+#include "network_packet.h"
+#include "../simdebug.h"
+#include "../sys/simsys.h"
+#include "../utils/checklist.h"
+
+#include <string.h>
+
+
+#define JOURNAL_MAGIC "SimJrnl"
+// version 2 added the reloads and the checklists, without them a replay cannot be verified
+#define JOURNAL_VERSION (2)
+
+
+command_journal_t *command_journal_t::recorder = NULL;
+
+
+// the journal is stored in little endian independent of the platform
+static void write_uint16(FILE *f, uint16 v)
+{
+	const uint8 b[2] = { (uint8)v, (uint8)(v >> 8) };
+	fwrite( b, 1, 2, f );
+}
+
+
+static void write_uint32(FILE *f, uint32 v)
+{
+	const uint8 b[4] = { (uint8)v, (uint8)(v >> 8), (uint8)(v >> 16), (uint8)(v >> 24) };
+	fwrite( b, 1, 4, f );
+}
+
+
+static bool read_uint16(FILE *f, uint16 &v)
+{
+	uint8 b[2];
+	if(  fread( b, 1, 2, f ) != 2  ) {
+		return false;
+	}
+	v = b[0] | (b[1] << 8);
+	return true;
+}
+
+
+static bool read_uint32(FILE *f, uint32 &v)
+{
+	uint8 b[4];
+	if(  fread( b, 1, 4, f ) != 4  ) {
+		return false;
+	}
+	v = b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32)b[3] << 24);
+	return true;
+}
+
+
+command_journal_t::command_journal_t() :
+	file(NULL),
+	recording(false),
+	broken(false),
+	start_time(0),
+	count(0),
+	last_sync_step(0)
+{
+}
+
+
+command_journal_t::~command_journal_t()
+{
+	close();
+}
+
+
+bool command_journal_t::open_record(const char *filename)
+{
+	close();
+	file = dr_fopen( filename, "wb" );
+	if(  file == NULL  ) {
+		dbg->warning( "command_journal_t::open_record", "Cannot create journal %s", filename );
+		return false;
+	}
+	fwrite( JOURNAL_MAGIC, 1, sizeof(JOURNAL_MAGIC), file );
+	write_uint32( file, JOURNAL_VERSION );
+	recording = true;
+	start_time = dr_time();
+	count = 0;
+	return true;
+}
+
+
+bool command_journal_t::open_replay(const char *filename)
+{
+	close();
+	file = dr_fopen( filename, "rb" );
+	if(  file == NULL  ) {
+		dbg->warning( "command_journal_t::open_replay", "Cannot open journal %s", filename );
+		return false;
+	}
+	char magic[sizeof(JOURNAL_MAGIC)];
+	uint32 version = 0;
+	if(  fread( magic, 1, sizeof(JOURNAL_MAGIC), file ) != sizeof(JOURNAL_MAGIC)  ||  memcmp( magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC) ) != 0
+		||  !read_uint32( file, version )  ||  version != JOURNAL_VERSION  ) {
+		dbg->warning( "command_journal_t::open_replay", "%s is not a command journal of a supported version", filename );
+		close();
+		return false;
+	}
+	recording = false;
+	broken = false;
+	count = 0;
+	last_sync_step = 0;
+	return true;
+}
+
+
+void command_journal_t::finish(uint32 sync_step)
+{
+	if(  is_recording()  ) {
+		// the end marker is an empty record with an invalid command id
+		write_uint32( file, sync_step );
+		write_uint32( file, dr_time() - start_time );
+		write_uint16( file, NWC_INVALID );
+		write_uint16( file, 0 );
+	}
+	close();
+}
+
+
+void command_journal_t::close()
+{
+	if(  file  ) {
+		fclose( file );
+		file = NULL;
+	}
+	recording = false;
+}
+
+
+void command_journal_t::record(network_world_command_t *nwc, uint32 sync_step)
+{
+	if(  !is_recording()  ) {
+		return;
+	}
+	packet_t *p = nwc->write_to_new_packet();
+	if(  p->has_failed()  ) {
+		dbg->warning( "command_journal_t::record", "Cannot record %s at sync_step %u", nwc->get_name(), sync_step );
+	}
+	else {
+		write_uint32( file, sync_step );
+		write_uint32( file, dr_time() - start_time );
+		write_uint16( file, nwc->get_id() );
+		write_uint16( file, p->get_data_size() );
+		fwrite( p->get_data(), 1, p->get_data_size(), file );
+		count ++;
+	}
+	delete p;
+}
+
+
+void command_journal_t::record_sync(uint32 sync_step)
+{
+	if(  is_recording()  ) {
+		// only the position matters, the game is not stored
+		write_uint32( file, sync_step );
+		write_uint32( file, dr_time() - start_time );
+		write_uint16( file, NWC_SYNC );
+		write_uint16( file, 0 );
+	}
+}
+
+
+void command_journal_t::record_checklist(const checklist_t &chk, uint32 sync_step)
+{
+	if(  !is_recording()  ) {
+		return;
+	}
+	packet_t p;
+	checklist_t c = chk;
+	c.rdwr( &p, NETWORK_VERSION );
+	write_uint32( file, sync_step );
+	write_uint32( file, dr_time() - start_time );
+	write_uint16( file, NWC_CHECK );
+	write_uint16( file, p.get_data_size() );
+	fwrite( p.get_data(), 1, p.get_data_size(), file );
+}
+
+
+command_journal_t::record_type_t command_journal_t::read(uint32 &sync_step, uint32 &time_ms, network_world_command_t *&nwc, checklist_t &chk)
+{
+	nwc = NULL;
+	if(  file == NULL  ||  recording  ) {
+		return RECORD_END;
+	}
+
+	uint16 id, len;
+	uint8 data[MAX_PACKET_LEN];
+	while(  read_uint32( file, sync_step )  &&  read_uint32( file, time_ms )  &&  read_uint16( file, id )  &&  read_uint16( file, len )  ) {
+		if(  len > MAX_PACKET_LEN - HEADER_SIZE  ||  fread( data, 1, len, file ) != len  ) {
+			break;
+		}
+		last_sync_step = sync_step;
+		switch(  id  ) {
+			case NWC_INVALID:
+				// end marker
+				return RECORD_END;
+
+			case NWC_SYNC:
+				return RECORD_SYNC;
+
+			case NWC_CHECK: {
+				packet_t p( id, data, len );
+				chk.rdwr( &p, p.get_version() );
+				if(  p.has_failed()  ) {
+					dbg->error( "command_journal_t::read", "Broken checklist at sync_step %u", sync_step );
+					broken = true;
+					return RECORD_END;
+				}
+				return RECORD_CHECKLIST;
+			}
+
+			default: {
+				// read_from_packet takes ownership of the packet
+				network_command_t *cmd = network_command_t::read_from_packet( new packet_t( id, data, len ) );
+				if(  network_world_command_t *nwwc = dynamic_cast<network_world_command_t *>(cmd)  ) {
+					count ++;
+					nwc = nwwc;
+					return RECORD_COMMAND;
+				}
+				// a replay without this command would not be the recorded game
+				dbg->error( "command_journal_t::read", "Unreadable command (id=%u) at sync_step %u", id, sync_step );
+				delete cmd;
+				broken = true;
+				return RECORD_END;
+			}
+		}
+	}
+	dbg->error( "command_journal_t::read", "Journal ends without end marker after sync_step %u", last_sync_step );
+	broken = true;
+	return RECORD_END;
+}
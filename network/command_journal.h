@@ -0,0 +1,101 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef NETWORK_COMMAND_JOURNAL_H
+#define NETWORK_COMMAND_JOURNAL_H
+
+
+#include "../simtypes.h"
+
+#include <stdio.h>
+
+class network_world_command_t;
+struct checklist_t;
+
+
+/**
+ * Journal of the network world commands executed by this game.
+ * Every command is stored with the sync step at which it was executed and the
+ * time since the recording started, so a game can be replayed deterministically
+ * starting from the savegame written when the recording started.
+ * The reloads for joining clients (nwc_sync_t) and the checklists sent to the
+ * clients are recorded too, so the replay can reload at the same sync steps and
+ * verify that it still plays the recorded game.
+ * @see karte_t::replay_journal()
+ */
+class command_journal_t
+{
+private:
+	FILE *file;
+	bool recording;
+
+	/// set when a replayed journal turned out to be truncated or unreadable
+	bool broken;
+
+	/// time when recording started, in ms
+	uint32 start_time;
+
+	uint32 count;
+
+	/// sync step of the last command or of the end marker
+	uint32 last_sync_step;
+
+public:
+	/// kinds of records returned by read()
+	enum record_type_t {
+		RECORD_COMMAND,
+		RECORD_SYNC,      ///< the game was saved and reloaded for a joining client
+		RECORD_CHECKLIST, ///< the checklist the game had at this sync step
+		RECORD_END
+	};
+
+	command_journal_t();
+	~command_journal_t();
+
+	/// @returns false, if the file could not be created
+	bool open_record(const char *filename);
+
+	/// @returns false, if the file could not be opened or is no command journal
+	bool open_replay(const char *filename);
+
+	/// writes the end marker (so a replay runs until @p sync_step) and closes the journal
+	void finish(uint32 sync_step);
+
+	void close();
+
+	bool is_recording() const { return file  &&  recording; }
+
+	bool is_broken() const { return broken; }
+
+	/// number of commands recorded or read so far
+	uint32 get_count() const { return count; }
+
+	/// during replay: sync step of the last command read, or the end of the recording once everything is read
+	uint32 get_last_sync_step() const { return last_sync_step; }
+
+	/// appends a command executed at @p sync_step
+	void record(network_world_command_t *nwc, uint32 sync_step);
+
+	/// appends the reload of the game for a joining client at @p sync_step
+	void record_sync(uint32 sync_step);
+
+	/// appends the checklist @p chk of @p sync_step
+	void record_checklist(const checklist_t &chk, uint32 sync_step);
+
+	/**
+	 * reads the next record
+	 * @param sync_step the sync step, at which the record was written
+	 * @param time_ms the time, at which the record was written, relative to the start of the recording
+	 * @param nwc set to the command (to be deleted by the caller) for RECORD_COMMAND
+	 * @param chk set to the checklist for RECORD_CHECKLIST
+	 * @returns the kind of the record, RECORD_END at the end of the journal
+	 */
+	record_type_t read(uint32 &sync_step, uint32 &time_ms, network_world_command_t *&nwc, checklist_t &chk);
+
+	/// the journal this game records into (or NULL)
+	static command_journal_t *recorder;
+};
+
+#endif
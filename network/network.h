@@ -68,7 +68,9 @@
 
 
 // version of network protocol code
-#define NETWORK_VERSION (1)
+// 2: checklists carry the subsystem hashes
+#define NETWORK_VERSION (2)
+#define NETWORK_VERSION_SUBSYSTEM_HASHES (2)
 
 class network_command_t;
 class gameinfo_t;
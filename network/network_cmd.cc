@@ -92,6 +92,21 @@ packet_t* network_command_t::copy_packet() const
 }
 
 
+packet_t* network_command_t::write_to_new_packet()
+{
+	packet_t *const own_packet = packet;
+	const bool own_ready = ready;
+
+	packet = new packet_t();
+	rdwr();
+	packet_t *const new_packet = packet;
+
+	packet = own_packet;
+	ready = own_ready;
+	return new_packet;
+}
+
+
 void nwc_auth_player_t::rdwr()
 {
 	network_command_t::rdwr();
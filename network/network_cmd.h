@@ -87,6 +87,13 @@ public:
 	 */
 	packet_t *copy_packet() const;
 
+	/**
+	 * writes the command into a new packet, leaving the own packet untouched
+	 * (works also for received commands, whose packet is in loading-mode)
+	 * @returns the new packet, to be deleted by the caller
+	 */
+	packet_t *write_to_new_packet();
+
 	// creates an instance:
 	// gets the nwc-id from the packet, and reads its data
 	static network_command_t* read_from_packet(packet_t *p);
@@ -21,6 +21,7 @@
 #include "../sys/simsys.h"
 #include "../dataobj/environment.h"
 #include "../player/simplay.h"
+#include "../bauer/wegbauer.h"
 #include "../gui/player_frame_t.h"
 #include "../utils/simrandom.h"
 #include "../utils/cbuffer_t.h"
@@ -541,7 +542,7 @@ void nwc_ready_t::rdwr()
 	network_command_t::rdwr();
 	packet->rdwr_long(sync_step);
 	packet->rdwr_long(map_counter);
-	checklist.rdwr(packet);
+	checklist.rdwr(packet, packet->get_version());
 }
 
 
@@ -992,7 +993,7 @@ path_explorer_t::limit_set_t nwc_routesearch_t::calc_min_limits()
 void nwc_check_t::rdwr()
 {
 	network_world_command_t::rdwr();
-	server_checklist.rdwr(packet);
+	server_checklist.rdwr(packet, packet->get_version());
 	packet->rdwr_long(server_sync_step);
 	if (packet->is_loading()  &&  env_t::server) {
 		// server does not receive nwc_check_t-commands
@@ -1195,7 +1196,7 @@ void nwc_tool_t::rdwr()
 {
 	network_broadcast_world_command_t::rdwr();
 	packet->rdwr_long(last_sync_step);
-	last_checklist.rdwr(packet);
+	last_checklist.rdwr(packet, packet->get_version());
 	packet->rdwr_byte(player_nr);
 	sint16 posx = pos.x; packet->rdwr_short(posx); pos.x = posx;
 	sint16 posy = pos.y; packet->rdwr_short(posy); pos.y = posy;
@@ -1389,6 +1390,8 @@ void nwc_tool_t::do_command(karte_t *welt)
 			active_tool->cleanup();
 		}
 		const char *err = tool->work( player, pos );
+		// the map may have changed (terraforming, removals, ...), kept route searches are outdated
+		way_builder_t::map_changed();
 		// only local players get the callback
 		if (local  /*&&  callback_id == 0*/  &&  player) {
 			player->tell_tool_result(tool, pos, err);
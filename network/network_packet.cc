@@ -7,6 +7,8 @@
 #include "network_packet.h"
 #include "network_socket_list.h"
 
+#include <string.h>
+
 
 void packet_t::rdwr_header()
 {
@@ -60,6 +62,27 @@ packet_t::packet_t(SOCKET sender) : memory_rw_t(buf,MAX_PACKET_LEN,false)
 }
 
 
+packet_t::packet_t(uint16 id_, const uint8 *data, uint16 len) : memory_rw_t(buf,MAX_PACKET_LEN,false)
+{
+	if(  len > MAX_PACKET_LEN - HEADER_SIZE  ) {
+		len = 0;
+		error = true;
+	}
+	else {
+		error = false;
+	}
+	memcpy( buf + HEADER_SIZE, data, len );
+	size = HEADER_SIZE + len;
+	version = NETWORK_VERSION;
+	id = id_;
+	sock = INVALID_SOCKET;
+	ready = true;
+	count = size;
+	set_max_size(size);
+	set_index(HEADER_SIZE);
+}
+
+
 void packet_t::recv()
 {
 	if (error  ||  ready) {
@@ -54,6 +54,12 @@ public:
 	 */
 	packet_t(SOCKET s);
 
+	/**
+	 * constructor: packet is in loading-mode and holds a copy of @p len bytes
+	 * of command data (everything after the header), e.g. from a command journal
+	 */
+	packet_t(uint16 id, const uint8 *data, uint16 len);
+
 	/**
 	 * start/continue sending
 	 * sets bools ready or error
@@ -74,7 +80,14 @@ public:
 	// can we understand the received packet?
 	bool check_version() const { return is_saving() || (version <= NETWORK_VERSION); }
 
+	/// protocol version of the sender (NETWORK_VERSION for own packets)
+	uint16 get_version() const { return version; }
+
 	uint16 get_id() const { return id; }
+
+	/// data written to a packet in saving-mode (everything after the header), valid until it is sent
+	const uint8 *get_data() const { return buf + HEADER_SIZE; }
+	uint16 get_data_size() const { return get_current_index() - HEADER_SIZE; }
 	void set_id(uint16 id_) { id = id_; }
 
 	SOCKET get_sender() { return sock; }
@@ -201,6 +201,25 @@ void obj_t::rdwr(loadsave_t *file)
 }
 
 
+// draws a single background image with the owner colours
+inline void obj_t::display_image(image_id image, int xpos, int ypos, bool is_dirty  CLIP_NUM_DEF) const
+{
+	if(  owner_n != PLAYER_UNOWNED  ) {
+		if(  obj_t::show_owner && welt->get_player(owner_n))
+		{
+			display_blend( image, xpos, ypos, owner_n, color_idx_to_rgb(welt->get_player(owner_n)->get_player_color1()+2) | OUTLINE_FLAG | TRANSPARENT75_FLAG, 0, is_dirty  CLIP_NUM_PAR);
+		}
+		else
+		{
+			display_color( image, xpos, ypos, owner_n, true, is_dirty  CLIP_NUM_PAR);
+		}
+	}
+	else {
+		display_normal( image, xpos, ypos, 0, true, is_dirty  CLIP_NUM_PAR);
+	}
+}
+
+
 /**
  * draw the object
  * the dirty-flag is reset from objlist_t::display_obj_fg, or objlist_t::display_overlay when multithreaded
@@ -222,20 +241,7 @@ void obj_t::display(int xpos, int ypos  CLIP_NUM_DEF) const
 
 		const int start_ypos = ypos;
 		for(  int j=0;  image!=IMG_EMPTY;  ) {
-
-			if(  owner_n != PLAYER_UNOWNED  ) {
-				if(  obj_t::show_owner && welt->get_player(owner_n))
-				{
-					display_blend( image, xpos, ypos, owner_n, color_idx_to_rgb(welt->get_player(owner_n)->get_player_color1()+2) | OUTLINE_FLAG | TRANSPARENT75_FLAG, 0, is_dirty  CLIP_NUM_PAR);
-				}
-				else
-				{
-					display_color( image, xpos, ypos, owner_n, true, is_dirty  CLIP_NUM_PAR);
-				}
-			}
-			else {
-				display_normal( image, xpos, ypos, 0, true, is_dirty  CLIP_NUM_PAR);
-			}
+			display_image( image, xpos, ypos, is_dirty  CLIP_NUM_PAR);
 			// this obj has another image on top (e.g. skyscraper)
 			ypos -= raster_width;
 			image = get_image(++j);
@@ -265,6 +271,23 @@ void obj_t::display(int xpos, int ypos  CLIP_NUM_DEF) const
 }
 
 
+/**
+ * draw background images collected before by objlist_t for a non-moving, non-dirty object without outline
+ */
+void obj_t::display_images(const image_id *images, int xpos, int ypos  CLIP_NUM_DEF) const
+{
+	if(  *images != IMG_EMPTY  ) {
+		const int raster_width = get_current_tile_raster_width();
+		xpos += tile_raster_scale_x(get_xoff(), raster_width);
+		ypos += tile_raster_scale_y(get_yoff(), raster_width);
+		for(  ;  *images != IMG_EMPTY;  images++  ) {
+			display_image( *images, xpos, ypos, false  CLIP_NUM_PAR);
+			ypos -= raster_width;
+		}
+	}
+}
+
+
 // called during map rotation
 void obj_t::rotate90()
 {
@@ -320,6 +343,11 @@ void obj_t::display_after(int xpos, int ypos, bool) const
  */
 void obj_t::mark_image_dirty(image_id image, sint16 yoff) const
 {
+	if(  !is_moving()  ) {
+		// the image is about to change: dirty objects are drawn live, and
+		// clearing the flag after drawing renews the cached images of the tile
+		const_cast<obj_t *>(this)->set_flag( dirty );
+	}
 	if(  image != IMG_EMPTY  ) {
 		const sint16 rasterweite = get_tile_raster_width();
 		int xpos=0, ypos=0;
@@ -48,6 +48,9 @@ private:
 	obj_t(obj_t const&);
 	obj_t& operator=(obj_t const&);
 
+	/// draw one background image with the owner colours
+	void display_image(image_id image, int xpos, int ypos, bool is_dirty  CLIP_NUM_DEF) const;
+
 	/**
 	 * Coordinate of position
 	 */
@@ -330,6 +333,12 @@ public:
 	 */
 	void display(int xpos, int ypos  CLIP_NUM_DEF) const;
 
+	/**
+	 * Draw background images cached by objlist_t (terminated by IMG_EMPTY),
+	 * only used for non-moving objects without outline which are not dirty
+	 */
+	void display_images(const image_id *images, int xpos, int ypos  CLIP_NUM_DEF) const;
+
 	/**
 	 * Draw foreground image
 	 * (everything that is in front of vehicles)
@@ -60,6 +60,8 @@ ai_goods_t::ai_goods_t(uint8 nr) : ai_t(nr)
 
 	next_construction_steps = welt->get_steps()+ 50;
 
+	planning = false;
+
 	road_transport = nr!=7;
 	rail_transport = nr>2;
 	ship_transport = true;
@@ -771,6 +773,39 @@ DBG_MESSAGE("ai_goods_t::create_simple_rail_transport()","building simple track
 
 
 // the normal length procedure for freight AI
+bool ai_goods_t::begin_planning()
+{
+	// only the search for a tree root in NR_INIT is planned
+	planning = active  &&  state == NR_INIT  &&  root == NULL  &&  welt->get_steps() >= next_construction_steps  &&
+		finance->get_netwealth() >= finance->get_starting_money()/8;
+	if(  planning  ) {
+		planned_missing.clear();
+		planned_missing.resize( welt->get_fab_list().get_count() );
+		for(  uint32 i = 0;  i < welt->get_fab_list().get_count();  i++  ) {
+			planned_missing.append( -1 );
+		}
+	}
+	return planning;
+}
+
+
+void ai_goods_t::plan(sint16 y_min, sint16 y_max)
+{
+	if(  !planning  ) {
+		return;
+	}
+	const vector_tpl<fabrik_t*> &fab_list = welt->get_fab_list();
+	for(  uint32 i = 0;  i < fab_list.get_count();  i++  ) {
+		fabrik_t *fab = fab_list[i];
+		const sint16 y = fab->get_pos().y;
+		// consumer and not completely overcrowded
+		if(  y >= y_min  &&  y < y_max  &&  fab->get_desc()->is_consumer_only()  &&  fab->get_status() < fabrik_t::bad  ) {
+			planned_missing[i] = get_factory_tree_missing_count( fab );
+		}
+	}
+}
+
+
 void ai_goods_t::step()
 {
 	// needed for schedule of stops ...
@@ -801,13 +836,21 @@ void ai_goods_t::step()
 			if(root==NULL) {
 				// find a tree root to complete
 				weighted_vector_tpl<fabrik_t *> start_fabs(20);
-				FOR(vector_tpl<fabrik_t*>, const fab, welt->get_fab_list()) {
-					// consumer and not completely overcrowded
-					if(  fab->get_desc()->is_consumer_only()  &&  fab->get_status() < fabrik_t::bad  ) {
-						int missing = get_factory_tree_missing_count( fab );
-						if(  missing>0  ) {
-							start_fabs.append( fab, 100/(missing+1)+1 );
-						}
+				const vector_tpl<fabrik_t*> &fab_list = welt->get_fab_list();
+				// use the plan if made for this step (and the factories did not change since)
+				const bool planned = planning  &&  planned_missing.get_count() == fab_list.get_count();
+				for(  uint32 i = 0;  i < fab_list.get_count();  i++  ) {
+					fabrik_t *fab = fab_list[i];
+					int missing = -1;
+					if(  planned  ) {
+						missing = planned_missing[i];
+					}
+					else if(  fab->get_desc()->is_consumer_only()  &&  fab->get_status() < fabrik_t::bad  ) {
+						// consumer and not completely overcrowded
+						missing = get_factory_tree_missing_count( fab );
+					}
+					if(  missing>0  ) {
+						start_fabs.append( fab, 100/(missing+1)+1 );
 					}
 				}
 				if(  !start_fabs.empty()  ) {
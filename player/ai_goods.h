@@ -82,6 +82,13 @@ private:
 
 	slist_tpl<fabconnection_t*> forbidden_connections;
 
+	/// true while the missing counts of the factory trees are planned for NR_INIT
+	bool planning;
+
+	/// result of get_factory_tree_missing_count() for each factory in welt->get_fab_list(),
+	/// -1 if the factory is not a root candidate
+	vector_tpl<sint32> planned_missing;
+
 	// return true, if this a route to avoid (i.e. we did a construction without success here ...)
 	bool is_forbidden( fabrik_t *fab1, fabrik_t *fab2, const goods_desc_t *w ) const;
 
@@ -122,6 +129,10 @@ public:
 
 	bool set_active( bool b ) OVERRIDE;
 
+	bool begin_planning() OVERRIDE;
+
+	void plan(sint16 y_min, sint16 y_max) OVERRIDE;
+
 	void step() OVERRIDE;
 
 	void new_year() OVERRIDE;
@@ -391,6 +391,19 @@ public:
 	 */
 	virtual void step();
 
+	/**
+	 * Called before step(): returns true if the player wants plan() to be called
+	 * for this step (only needed for AI at the moment).
+	 */
+	virtual bool begin_planning() { return false; }
+
+	/**
+	 * Read-only preparation of step() for the map rows y_min ... y_max-1.
+	 * Runs in parallel for different rows and together with other players,
+	 * hence must neither change the world nor use simrand.
+	 */
+	virtual void plan(sint16 /*y_min*/, sint16 /*y_max*/) {}
+
 	/**
 	 * Called monthly by simworld.cc during simulation
 	 * @returns false if player has to be removed (bankrupt/inactive)
@@ -129,6 +129,34 @@ SQInteger halt_compare(halthandle_t a, halthandle_t b)
 }
 
 
+vector_tpl<halthandle_t> const& halt_get_list(const player_t *player)
+{
+	static vector_tpl<halthandle_t> list;
+	list.clear();
+	FOR(vector_tpl<halthandle_t>, const halt, haltestelle_t::get_alle_haltestellen()) {
+		if(  player == NULL  ||  halt->get_owner() == player  ) {
+			list.append(halt);
+		}
+	}
+	return list;
+}
+
+
+vector_tpl<uint32> const& halt_get_waiting_list(const player_t *player, const goods_desc_t *desc)
+{
+	static vector_tpl<uint32> list;
+	list.clear();
+	if (desc) {
+		FOR(vector_tpl<halthandle_t>, const halt, haltestelle_t::get_alle_haltestellen()) {
+			if(  player == NULL  ||  halt->get_owner() == player  ) {
+				list.append( halt->get_ware_summe(desc) );
+			}
+		}
+	}
+	return list;
+}
+
+
 // vector_tpl<haltestelle_t::connection_t> const& halt_get_connections(const haltestelle_t *halt, const goods_desc_t* freight)
 // {
 // 	static vector_tpl<haltestelle_t::connection_t> dummy;
@@ -301,6 +329,20 @@ void export_halt(HSQUIRRELVM vm)
 	 * @return halt instance
 	 */
 	STATIC register_method(vm, &get_halt_from_koord3d, "get_halt", false, true);
+	/**
+	 * Returns all halts of a player.
+	 * @param pl owner of the halts, null returns the halts of all players
+	 * @typemask array<halt_x>(player_x)
+	 */
+	STATIC register_method(vm, &halt_get_list, "get_halt_list", false, true);
+	/**
+	 * Returns the amount of waiting freight of one type for all halts of a player in one call.
+	 * The entries are in the same order as the halts returned by @ref get_halt_list.
+	 * @param pl owner of the halts, null returns the amounts for the halts of all players
+	 * @param freight freight type
+	 * @typemask array<integer>(player_x,good_desc_x)
+	 */
+	STATIC register_method(vm, &halt_get_waiting_list, "get_waiting_list", false, true);
 
 	end_class(vm);
 }
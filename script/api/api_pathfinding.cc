@@ -12,10 +12,14 @@
 #include "../api_class.h"
 #include "../api_function.h"
 #include "../../bauer/brueckenbauer.h"
+#include "../../bauer/vehikelbauer.h"
 #include "../../bauer/wegbauer.h"
+#include "../../dataobj/route.h"
 #include "../../descriptor/bridge_desc.h"
 #include "../../descriptor/way_desc.h"
+#include "../../descriptor/vehicle_desc.h"
 #include "../../tpl/binary_heap_tpl.h"
+#include "../../vehicle/vehicle.h"
 #include "../../simworld.h"
 
 
@@ -122,6 +126,51 @@ bool way_builder_is_allowed_step(way_builder_t *bob, grund_t *from, grund_t *to)
 }
 
 
+vector_tpl<koord3d> const& way_builder_calc_route(way_builder_t *bob, koord3d from, koord3d to)
+{
+	static vector_tpl<koord3d> list;
+	list.clear();
+	if (bob->get_desc() == NULL  ||  welt->lookup(from) == NULL  ||  welt->lookup(to) == NULL) {
+		return list;
+	}
+	bob->calc_route(from, to);
+	if (bob->get_count() > 1) {
+		FOR(koord3d_vector_t, const& pos, bob->get_route()) {
+			list.append(pos);
+		}
+	}
+	return list;
+}
+
+sint64 way_builder_get_costs(way_builder_t *bob)
+{
+	return bob->get_count() > 1 ? bob->calc_costs() : 0;
+}
+
+
+vector_tpl<koord3d> const& route_planner_find_route(player_t *player, const vehicle_desc_t *desc, koord3d from, koord3d to, sint64 max_cost)
+{
+	static vector_tpl<koord3d> list;
+	list.clear();
+	if (desc == NULL  ||  welt->lookup(from) == NULL  ||  welt->lookup(to) == NULL) {
+		return list;
+	}
+	// same kind of test driver as used for the diversion check in grund_t
+	vehicle_t *test_driver = vehicle_builder_t::build(from, player ? player : welt->get_public_player(), NULL, desc);
+	test_driver->set_flag(obj_t::not_on_map);
+
+	route_t route;
+	const route_t::route_result_t result = route.calc_route(welt, from, to, test_driver, desc->get_topspeed(), desc->get_axle_load(), desc->get_is_tall(), 0, max_cost > 0 ? max_cost : SINT64_MAX_VALUE);
+	if (result == route_t::valid_route  ||  result == route_t::valid_route_halt_too_short) {
+		FOR(koord3d_vector_t, const& pos, route.get_route()) {
+			list.append(pos);
+		}
+	}
+	delete test_driver;
+	return list;
+}
+
+
 koord3d bridge_builder_find_end_pos(player_t *player, koord3d pos, my_ribi_t mribi, const bridge_desc_t *bridge, uint32 min_length)
 {
 	const char* err;
@@ -204,6 +253,50 @@ void export_pathfinding(HSQUIRRELVM vm)
 	 * @param to to here, @p from and @p to must be adjacent.
 	 */
 	register_method(vm, way_builder_is_allowed_step, "is_allowed_step", true);
+	/**
+	 * Searches a route for a new way from @p from to @p to with the native way search.
+	 * Needs @ref set_build_types to be called before.
+	 * @param from start tile
+	 * @param to end tile
+	 * @returns array of coordinates of the tiles along the route, empty if no route was found
+	 */
+	register_method(vm, way_builder_calc_route, "calc_route", true);
+	/**
+	 * @returns costs to build the route found by the last call of @ref calc_route
+	 */
+	register_method(vm, way_builder_get_costs, "get_costs", true);
+	/**
+	 * Limits the way search: routes costing more than @p cost are not considered.
+	 * @param cost maximum costs of the route, default is 2000
+	 */
+	register_method(vm, &way_builder_t::set_maximum, "set_max_cost");
+	/**
+	 * If true, the way search does not cross other ways.
+	 * @param forbid
+	 */
+	register_method(vm, &way_builder_t::set_forbid_crossings, "set_forbid_crossings");
+	/**
+	 * If true, existing ways along the route are kept and not replaced.
+	 * @param keep
+	 */
+	register_method(vm, &way_builder_t::set_keep_existing_ways, "set_keep_existing_ways");
+
+	end_class(vm);
+
+	/**
+	 * Class with helper methods for route search along existing ways.
+	 */
+	create_class(vm, "route_planner_x", 0);
+	/**
+	 * Searches a route along existing ways, as a convoy with vehicles of type @p veh would do.
+	 * @param pl player owning the convoy, access rights to private ways and depots are checked against this player
+	 * @param veh vehicle descriptor, determines waytype, speed, axle load and height
+	 * @param from start tile
+	 * @param to end tile
+	 * @param max_cost routes more expensive than this are not considered, 0 means no limit
+	 * @returns array of coordinates of the tiles along the route, empty if no route was found
+	 */
+	STATIC register_method(vm, route_planner_find_route, "find_route", false, true);
 
 	end_class(vm);
 
@@ -130,6 +130,34 @@ vector_tpl<convoihandle_t> const get_convoy_list(grund_t* gr)
 	return list;
 }
 
+vector_tpl<weg_t*> const& get_ways_in_rect(koord corner1, koord corner2, waytype_t wt)
+{
+	static vector_tpl<weg_t*> list;
+	list.clear();
+
+	const sint16 x_min = max( 0, min(corner1.x, corner2.x) );
+	const sint16 y_min = max( 0, min(corner1.y, corner2.y) );
+	const sint16 x_max = min( welt->get_size().x-1, max(corner1.x, corner2.x) );
+	const sint16 y_max = min( welt->get_size().y-1, max(corner1.y, corner2.y) );
+	// wt_all is invalid_wt, see api_const.cc
+	const bool accept_all_wt = wt == invalid_wt  ||  wt == ignore_wt  ||  wt == any_wt;
+	for(  sint16 y = y_min;  y <= y_max;  y++  ) {
+		for(  sint16 x = x_min;  x <= x_max;  x++  ) {
+			const planquadrat_t *plan = welt->access(x, y);
+			for(  uint32 i = 0;  i < plan->get_boden_count();  i++  ) {
+				grund_t *gr = plan->get_boden_bei(i);
+				for(  uint8 j = 0;  j < 2;  j++  ) {
+					weg_t *way = gr->get_weg_nr(j);
+					if(  way  &&  (accept_all_wt  ||  way->get_waytype() == wt)  ) {
+						list.append(way);
+					}
+				}
+			}
+		}
+	}
+	return list;
+}
+
 void export_tiles(HSQUIRRELVM vm)
 {
 	/**
@@ -250,6 +278,15 @@ void export_tiles(HSQUIRRELVM vm)
 	 * @returns way object or null
 	 */
 	register_method(vm, &grund_t::get_weg, "get_way");
+	/**
+	 * Returns all ways in the rectangle spanned by @p corner1 and @p corner2 (on all heights)
+	 * in one call, which is much faster than querying the tiles one by one.
+	 * @param corner1 one corner of the rectangle
+	 * @param corner2 the opposite corner
+	 * @param wt waytype of the ways, wt_all returns ways of all types
+	 * @typemask array<way_x>(coord,coord,way_types)
+	 */
+	STATIC register_method(vm, &get_ways_in_rect, "get_ways_in_rect", false, true);
 	/**
 	 * Return directions in which ways on this tile go. One-way signs are ignored here.
 	 * @param wt waytype
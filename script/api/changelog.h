@@ -12,6 +12,8 @@
  * - Added @ref change_climate_at
  * - Added @ref convoy_x::change_schedule
  * - Changed building_desc_x::get_available_stations to accept wt_all
+ * - Added @ref route_planner_x, @ref way_planner_x::calc_route, @ref way_planner_x::get_costs and setters for the search constraints
+ * - Added @ref halt_x::get_halt_list, @ref halt_x::get_waiting_list, @ref tile_x::get_ways_in_rect
  *
  * @section api-123 Release 123.0
  *
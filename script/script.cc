@@ -5,6 +5,7 @@
 
 #include "script.h"
 
+#include <algorithm>
 #include <stdarg.h>
 #include <string.h>
 #include "../squirrel/sqstdaux.h" // for error handlers
@@ -14,9 +15,12 @@
 #include "../squirrel/sqstdsystem.h" // export for scripts
 #include "../squirrel/sq_extensions.h" // for sq_call_restricted
 
+#include "../dataobj/environment.h"
+#include "../sys/simsys.h"
 #include "../utils/log.h"
 
 #include "../tpl/inthashtable_tpl.h"
+#include "../tpl/stringhashtable_tpl.h"
 #include "../tpl/vector_tpl.h"
 // for error popups
 #include "../gui/help_frame.h"
@@ -35,6 +39,135 @@ namespace script_api {
 #define END_STACK_WATCH(v, delta) if ( (stack_top+(delta)) != sq_gettop(v)) { dbg->warning( __FUNCTION__, "(%d) stack in %d expected %d out %d", __LINE__,stack_top,stack_top+(delta),sq_gettop(v)); }
 
 
+/**
+ * Collects number of calls, inclusive time and allocations of the script functions.
+ * Fed by the native debug hook, i.e. only closures are profiled, time spent in
+ * native functions counts for the calling script function.
+ */
+class script_profiler_t
+{
+	struct entry_t {
+		char *name; ///< function and source, as written to the csv file
+		uint32 calls;
+		uint64 time_us;
+		uint64 allocations;
+	};
+
+	struct frame_t {
+		uint32 entry;
+		uint64 start_us;
+		uint64 start_allocations;
+	};
+
+	vector_tpl<entry_t> entries;
+	stringhashtable_tpl<uint32, N_BAGS_MEDIUM> index;
+
+	/// call stacks of vm (0) and thread (1)
+	vector_tpl<frame_t> stack[2];
+
+	/// time and allocation count when the vm got suspended, not to be accounted to the functions on its stack
+	bool paused[2];
+	uint64 paused_us[2];
+	uint64 paused_allocations[2];
+
+public:
+	script_profiler_t()
+	{
+		for(  uint8 nr = 0;  nr < 2;  nr++  ) {
+			paused[nr] = false;
+			paused_us[nr] = paused_allocations[nr] = 0;
+		}
+	}
+
+	~script_profiler_t()
+	{
+		FOR(vector_tpl<entry_t>, &e, entries) {
+			free(e.name);
+		}
+	}
+
+	void enter(uint8 nr, const char *source, const char *function)
+	{
+		char key[512];
+		snprintf(key, lengthof(key), "%s,\"%s\"", function ? function : "(anonymous)", source ? source : "");
+
+		uint32 i;
+		if(  const uint32 *found = index.access(key)  ) {
+			i = *found;
+		}
+		else {
+			i = entries.get_count();
+			entry_t e = { strdup(key), 0, 0, 0 };
+			entries.append(e);
+			index.put(e.name, i);
+		}
+		entries[i].calls++;
+
+		frame_t f = { i, dr_time_us(), sq_get_allocations() };
+		stack[nr].append(f);
+	}
+
+	void leave(uint8 nr)
+	{
+		if(  stack[nr].empty()  ) {
+			return;
+		}
+		const frame_t f = stack[nr].pop_back();
+		entries[f.entry].time_us += dr_time_us() - f.start_us;
+		entries[f.entry].allocations += sq_get_allocations() - f.start_allocations;
+	}
+
+	void pause(uint8 nr)
+	{
+		paused[nr] = true;
+		paused_us[nr] = dr_time_us();
+		paused_allocations[nr] = sq_get_allocations();
+	}
+
+	void resume(uint8 nr)
+	{
+		if(  !paused[nr]  ) {
+			return;
+		}
+		const uint64 delta_us = dr_time_us() - paused_us[nr];
+		const uint64 delta_allocations = sq_get_allocations() - paused_allocations[nr];
+		FOR(vector_tpl<frame_t>, &f, stack[nr]) {
+			f.start_us += delta_us;
+			f.start_allocations += delta_allocations;
+		}
+		paused[nr] = false;
+	}
+
+	/// call returned, drop the frames of functions left by errors
+	void finish(uint8 nr)
+	{
+		stack[nr].clear();
+		paused[nr] = false;
+	}
+
+	bool dump(const char *filename) const
+	{
+		FILE *f = dr_fopen(filename, "w");
+		if(  f == NULL  ) {
+			return false;
+		}
+		// slowest first
+		vector_tpl<const entry_t*> sorted(entries.get_count());
+		FOR(vector_tpl<entry_t>, const& e, entries) {
+			sorted.append(&e);
+		}
+		std::sort(sorted.begin(), sorted.end(), [](const entry_t *a, const entry_t *b) { return a->time_us > b->time_us; });
+
+		fprintf(f, "function,source,calls,inclusive_us,allocations\n");
+		FOR(vector_tpl<const entry_t*>, e, sorted) {
+			fprintf(f, "%s,%u,%llu,%llu\n", e->name, e->calls, (unsigned long long)e->time_us, (unsigned long long)e->allocations);
+		}
+		fclose(f);
+		return true;
+	}
+};
+
+
 void script_vm_t::printfunc(HSQUIRRELVM vm, const SQChar *s, ...)
 {
 	va_list vl;
@@ -107,6 +240,9 @@ void export_include(HSQUIRRELVM vm, const char* include_path); // api_include.cc
 script_vm_t::script_vm_t(const char* include_path_, const char* log_name)
 {
 	pause_on_error = false;
+	profiler = NULL;
+	step_start_ops = 0;
+	step_time_us = 0;
 
 	vm = sq_open(1024);
 	sqstd_seterrorhandlers(vm);
@@ -137,6 +273,19 @@ script_vm_t::script_vm_t(const char* include_path_, const char* log_name)
 	sq_setforeignptr(vm, this);
 	sq_setforeignptr(thread, this);
 
+	if (env_t::script_profile) {
+		profiler = new script_profiler_t();
+		sq_setnativedebughook(vm, profile_hook);
+		sq_setnativedebughook(thread, profile_hook);
+		// script-scenario.log -> script-scenario-profile.csv
+		std::string name(log_name);
+		if (name.size() > 4  &&  name.compare(name.size()-4, 4, ".log") == 0) {
+			name.erase(name.size()-4);
+		}
+		name += "-profile.csv";
+		profile_name = name.c_str();
+	}
+
 	error_msg = NULL;
 	include_path = include_path_;
 	// register libraries
@@ -162,9 +311,99 @@ script_vm_t::~script_vm_t()
 	// close vm, also closes thread
 	sq_close(vm);
 
+	if (profiler) {
+		if (!dump_profile(profile_name)) {
+			dbg->warning("script_vm_t::~script_vm_t", "Could not write script profile to %s", profile_name.c_str());
+		}
+		delete profiler;
+	}
 	delete log;
 }
 
+
+void script_vm_t::profile_hook(HSQUIRRELVM job, SQInteger type, const SQChar *sourcename, SQInteger, const SQChar *funcname)
+{
+	script_vm_t *script = (script_vm_t*)sq_getforeignptr(job);
+	if (script == NULL  ||  script->profiler == NULL) {
+		return;
+	}
+	const uint8 nr = job == script->vm ? 0 : 1;
+	if (type == 'c') {
+		script->profiler->enter(nr, sourcename, funcname);
+	}
+	else if (type == 'r') {
+		script->profiler->leave(nr);
+	}
+}
+
+
+bool script_vm_t::dump_profile(const char* filename) const
+{
+	return profiler  &&  profiler->dump(filename);
+}
+
+
+void script_vm_t::begin_step()
+{
+	step_start_ops = get_ops_executed();
+	step_time_us = 0;
+}
+
+
+sint64 script_vm_t::get_ops_executed() const
+{
+	return (sint64)sq_get_ops_executed(vm) + (sint64)sq_get_ops_executed(thread);
+}
+
+
+bool script_vm_t::is_step_budget_used_up() const
+{
+	if (env_t::script_step_ops  &&  get_ops_executed() - step_start_ops >= (sint64)env_t::script_step_ops) {
+		return true;
+	}
+	return env_t::script_step_ms  &&  step_time_us >= (uint64)env_t::script_step_ms * 1000;
+}
+
+
+uint32 script_vm_t::get_ops_grant(uint32 ops) const
+{
+	if (env_t::script_step_ops == 0) {
+		return ops;
+	}
+	const sint64 left = (sint64)env_t::script_step_ops - (get_ops_executed() - step_start_ops);
+	return left <= 0 ? 0 : (uint32)min((sint64)ops, left);
+}
+
+
+SQRESULT script_vm_t::intern_run(HSQUIRRELVM job, bool resume, int nparams, bool retvalue, bool throw_if_no_ops, uint32 ops)
+{
+	script_vm_t *script = (script_vm_t*)sq_getforeignptr(job);
+	const uint8 nr = job == script->vm ? 0 : 1;
+	if (script->profiler) {
+		script->profiler->resume(nr);
+	}
+	// calls may nest (script calls a tool, which asks the scenario), count the outermost only
+	static uint32 depth = 0;
+	const uint64 start_us = dr_time_us();
+	depth++;
+
+	SQRESULT ret = resume ? sq_resumevm(job, retvalue, ops) : sq_call_restricted(job, nparams, retvalue, throw_if_no_ops, ops);
+
+	depth--;
+	if (depth == 0) {
+		script->step_time_us += dr_time_us() - start_us;
+	}
+	if (script->profiler) {
+		if (sq_getvmstate(job) == SQ_VMSTATE_SUSPENDED) {
+			script->profiler->pause(nr);
+		}
+		else if (sq_getvmstate(job) == SQ_VMSTATE_IDLE) {
+			script->profiler->finish(nr);
+		}
+	}
+	return ret;
+}
+
 const char* script_vm_t::call_script(const char* filename)
 {
 	// load script
@@ -224,7 +463,7 @@ const char* script_vm_t::intern_prepare_call(HSQUIRRELVM &job, call_type_t ct, c
 			sq_block_suspend(job, function);
 			break;
 		case TRY:
-			if (sq_getvmstate(thread) == SQ_VMSTATE_SUSPENDED) {
+			if (sq_getvmstate(thread) == SQ_VMSTATE_SUSPENDED  ||  is_step_budget_used_up()) {
 				return "suspended";
 			}
 			// fall through
@@ -268,6 +507,10 @@ const char* script_vm_t::intern_finish_call(HSQUIRRELVM job, call_type_t ct, int
 		}
 		sq_pop(job, 2);
 	}
+	// budget of this step used up: queue the call, it will run in one of the next steps
+	if (!suspended  &&  ct == QUEUE  &&  is_step_budget_used_up()) {
+		suspended = true;
+	}
 	// queue function call?
 	if (suspended  &&  ct == QUEUE) {
 		intern_queue_call(job, nparams, retvalue);
@@ -303,8 +546,12 @@ const char* script_vm_t::intern_call_function(HSQUIRRELVM job, call_type_t ct, i
 	dbg->message("script_vm_t::intern_call_function", "start: stack=%d nparams=%d ret=%d", sq_gettop(job), nparams, retvalue);
 	const char* err = NULL;
 	uint32 opcodes = ct == FORCEX ? 100000 : 10000;
+	if (ct != FORCE  &&  ct != FORCEX) {
+		// at least one opcode, a call must not start with none
+		opcodes = max(1u, ((script_vm_t*)sq_getforeignptr(job))->get_ops_grant(opcodes));
+	}
 	// call the script
-	if (!SQ_SUCCEEDED(sq_call_restricted(job, nparams, retvalue, ct == FORCE  ||  ct == FORCEX, opcodes))) {
+	if (!SQ_SUCCEEDED(intern_run(job, false, nparams, retvalue, ct == FORCE  ||  ct == FORCEX, opcodes))) {
 		err = "Call function failed";
 		retvalue = false;
 	}
@@ -368,13 +615,22 @@ void script_vm_t::intern_resume_call(HSQUIRRELVM job)
 		dbg->message("script_vm_t::intern_resume_call", "waiting for return value");
 		return;
 	}
+	if (is_step_budget_used_up()) {
+		dbg->message("script_vm_t::intern_resume_call", "budget of this step used up");
+		return;
+	}
+	if (sq_getvmstate(job) == SQ_VMSTATE_IDLE) {
+		// nothing to resume, calls were queued as the budget of a step was used up
+		intern_call_queued(job);
+		return;
+	}
 	// vm suspended, but not from call to our methods
 	if (nparams < 0) {
 		retvalue = false;
 	}
 
 	// resume v.m.
-	if (!SQ_SUCCEEDED(sq_resumevm(job, retvalue, 10000))) {
+	if (!SQ_SUCCEEDED(intern_run(job, true, 0, retvalue, false, max(1u, get_ops_grant(10000))))) {
 		retvalue = false;
 	}
 	// if finished, clear stack
@@ -404,13 +660,7 @@ void script_vm_t::intern_resume_call(HSQUIRRELVM job)
 		sq_poptop(job);
 
 		// proceed with next call in queue
-		if (intern_prepare_queued(job, nparams, retvalue)) {
-			const char* err = intern_call_function(job, QUEUE, nparams, retvalue);
-			if (err == NULL  &&  retvalue) {
-				// remove return value: call was queued thus remove return value from stack
-				sq_poptop(job);
-			}
-		}
+		intern_call_queued(job);
 	}
 	else {
 		if (retvalue) {
@@ -421,6 +671,23 @@ void script_vm_t::intern_resume_call(HSQUIRRELVM job)
 	dbg->message("script_vm_t::intern_resume_call", "stack=%d", sq_gettop(job));
 }
 
+
+void script_vm_t::intern_call_queued(HSQUIRRELVM job)
+{
+	if (is_step_budget_used_up()) {
+		return;
+	}
+	int nparams = 0;
+	bool retvalue = false;
+	if (intern_prepare_queued(job, nparams, retvalue)) {
+		const char* err = intern_call_function(job, QUEUE, nparams, retvalue);
+		if (err == NULL  &&  retvalue) {
+			// remove return value: call was queued thus remove return value from stack
+			sq_poptop(job);
+		}
+	}
+}
+
 /**
  * Stack(job): expects closure, nparams*objects, clean on exit.
  * Put call into registry.queue, callback into registry.queued_callbacks.
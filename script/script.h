@@ -17,6 +17,7 @@
 #include <string>
 
 class log_t;
+class script_profiler_t;
 template<class key_t, class value_t, size_t n_bags> class inthashtable_tpl;
 void sq_setwakeupretvalue(HSQUIRRELVM v); //sq_extensions
 
@@ -154,6 +155,18 @@ public:
 	 */
 	void clear_pending_callback();
 
+	/**
+	 * Starts a new step: resets the opcode and time budget (env_t::script_step_ops, env_t::script_step_ms).
+	 * Calls queued while the budget was used up are resumed with the next call of a queued function.
+	 */
+	void begin_step();
+
+	/**
+	 * Writes the collected profile (if env_t::script_profile is set) as csv.
+	 * @returns false if there is no profile or the file could not be written
+	 */
+	bool dump_profile(const char* filename) const;
+
 private:
 	/// virtual machine running everything
 	HSQUIRRELVM vm;
@@ -169,6 +182,27 @@ private:
 	/// path to files to #include
 	plainstring include_path;
 
+	/// profile is written here
+	plainstring profile_name;
+
+	/// NULL if not profiling
+	script_profiler_t *profiler;
+
+	/// opcodes executed by vm and thread when the step started
+	sint64 step_start_ops;
+
+	/// time spent in scripts during this step
+	uint64 step_time_us;
+
+	/// total opcodes executed by vm and thread
+	sint64 get_ops_executed() const;
+
+	/// true if the opcodes or time allowed per step are used up
+	bool is_step_budget_used_up() const;
+
+	/// @returns how many of @p ops opcodes the next call or resume may use
+	uint32 get_ops_grant(uint32 ops) const;
+
 public:
 	bool pause_on_error;
 
@@ -192,6 +226,13 @@ private:
 	/// calls function. If it was a queued call, also calls callbacks.
 	static const char* intern_call_function(HSQUIRRELVM job, call_type_t ct, int nparams, bool retvalue);
 
+	/// calls the next function in the queue
+	void intern_call_queued(HSQUIRRELVM job);
+
+	/// runs the vm, accounts the time spent for the step budget and the profiler
+	/// @param resume resume suspended vm instead of calling the closure on the stack
+	static SQRESULT intern_run(HSQUIRRELVM job, bool resume, int nparams, bool retvalue, bool throw_if_no_ops, uint32 ops);
+
 	/// pops an queued call and puts it on the stack, also activates corresponding callbacks
 	bool intern_prepare_queued(HSQUIRRELVM job, int &nparams, bool &retvalue);
 
@@ -220,6 +261,9 @@ private:
 
 	/// custom print handler
 	static void printfunc(HSQUIRRELVM, const SQChar *s, ...);
+
+	/// debug hook feeding the profiler
+	static void profile_hook(HSQUIRRELVM vm, SQInteger type, const SQChar *sourcename, SQInteger line, const SQChar *funcname);
 };
 
 /**
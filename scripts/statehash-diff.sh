@@ -0,0 +1,54 @@
+#!/bin/bash
+#
+# This file is part of the Simutrans-Extended project under the Artistic License.
+# (see LICENSE.txt)
+#
+# Shows where two runs diverged, using the per-object state hash logs
+# written with -statehash_log (desync/statehash-*.txt).
+#
+# usage: statehash-diff.sh <first log> <second log>
+#
+# Each log line is "<step> <subsystem> <object> <hash>"; the subsystem
+# totals are written after the objects of a step. The first step whose
+# totals differ is reported together with all objects differing in it.
+
+if [ $# -ne 2 ]; then
+	echo "usage: $0 <first log> <second log>" >&2
+	exit 2
+fi
+
+awk '
+	NR == FNR {
+		a[$1 " " $2 " " $3] = $4
+		next
+	}
+	{
+		key = $1 " " $2 " " $3
+		if(  !(key in a)  ) {
+			missing[$1] = missing[$1] "\tonly in second run: " $2 " " $3 "\n"
+			diverged[$1] = 1
+		}
+		else if(  a[key] != $4  ) {
+			if(  $2 == "total"  ) {
+				totals[$1] = totals[$1] "\t" $3 " diverged\n"
+			}
+			else {
+				objects[$1] = objects[$1] "\t" $2 " " $3 ": " a[key] " != " $4 "\n"
+			}
+			diverged[$1] = 1
+		}
+		if(  !($1 in first)  ) {
+			first[$1] = 1
+			steps[++nsteps] = $1
+		}
+	}
+	END {
+		for(  i = 1;  i <= nsteps;  i++  ) {
+			if(  steps[i] in diverged  ) {
+				printf "runs diverged at step %s\n%s%s%s", steps[i], totals[steps[i]], objects[steps[i]], missing[steps[i]]
+				exit 1
+			}
+		}
+		print "no divergence found in " nsteps " common steps"
+	}
+' "$1" "$2"
@@ -0,0 +1,207 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "simbenchmark.h"
+#include "macros.h"
+#include "simworld.h"
+#include "simhalt.h"
+#include "simcity.h"
+#include "simfab.h"
+#include "simdebug.h"
+#include "simversion.h"
+#include "pathes.h"
+
+#include "dataobj/environment.h"
+#include "dataobj/freelist.h"
+#include "dataobj/settings.h"
+#include "player/simplay.h"
+#include "sys/simsys.h"
+#include "utils/cbuffer_t.h"
+#include "utils/checklist.h"
+#include "utils/step_profiler.h"
+
+
+// the built-in worlds; the map number fixes the landscape and the
+// position of cities and factories, the players add halts and convoys
+struct benchmark_world_t
+{
+	const char *name;
+	sint32 size_x, size_y;
+	sint32 map_number;
+	sint32 cities;
+	sint32 mean_citizens;
+	sint32 factories;
+	sint32 attractions;
+	uint8 ai_players;
+	// steps before the measurement, to let the players build their networks
+	uint32 warmup_steps;
+};
+
+static const benchmark_world_t worlds[] = {
+	{ "small",   256,  256, 1001,  16, 1600,  24,  8, 2,  100 },
+	{ "medium",  768,  768, 1002,  96, 2400, 128, 32, 4,  200 },
+	{ "large",  2048, 1536, 1003, 384, 3200, 512, 96, 6,  300 }
+};
+
+
+// appends str as JSON string
+static void json_string(cbuffer_t &buf, const char *str)
+{
+	buf.append( "\"" );
+	for(  const char *c = str;  *c;  c++  ) {
+		if(  *c == '"'  ||  *c == '\\'  ) {
+			buf.printf( "\\%c", *c );
+		}
+		else if(  (unsigned char)*c < 0x20  ) {
+			buf.printf( "\\u%04x", (unsigned char)*c );
+		}
+		else {
+			buf.printf( "%c", *c );
+		}
+	}
+	buf.append( "\"" );
+}
+
+
+static void create_world(karte_t *welt, const benchmark_world_t &world, uint32 &warmup_steps)
+{
+	settings_t sets = env_t::default_settings;
+	sets.set_default_climates();
+	sets.set_size( world.size_x, world.size_y );
+	sets.set_map_number( world.map_number );
+	sets.set_city_count( world.cities );
+	sets.set_mean_citizen_count( world.mean_citizens );
+	sets.set_factory_count( world.factories );
+	sets.set_tourist_attractions( world.attractions );
+	sets.set_use_timeline( 1 );
+	sets.set_starting_year( 1950 );
+	sets.set_starting_month( 0 );
+	welt->init( &sets, 0 );
+
+	// the first two players are the human and the public player
+	for(  uint8 i = 0;  i < world.ai_players;  i++  ) {
+		const uint8 nr = 2 + i;
+		if(  const char *err = welt->init_new_player( nr, (i & 1) ? player_t::AI_PASSENGER : player_t::AI_GOODS )  ) {
+			dbg->warning( "benchmark_t::run()", "Cannot create player %i: %s", nr, err );
+			continue;
+		}
+		welt->get_player(nr)->set_active( true );
+	}
+	warmup_steps = world.warmup_steps;
+}
+
+
+bool benchmark_t::run(karte_t *welt, const char *name, uint32 steps, const char *json_filename)
+{
+	const uint64 setup_start = dr_time_us();
+
+	uint32 warmup_steps = 0;
+	const benchmark_world_t *world = NULL;
+	for(  uint i = 0;  i < lengthof(worlds);  i++  ) {
+		if(  strcmp( worlds[i].name, name ) == 0  ) {
+			world = &worlds[i];
+		}
+	}
+	if(  world  ) {
+		create_world( welt, *world, warmup_steps );
+	}
+	else {
+		cbuffer_t buf;
+		dr_chdir( env_t::user_dir );
+		buf.printf( SAVE_PATH_X "%s.sve", name );
+		if(  !welt->load( buf )  ) {
+			dbg->error( "benchmark_t::run()", "\"%s\" is neither a built-in world nor a loadable savegame", name );
+			return false;
+		}
+	}
+	welt->set_fast_forward( false );
+	welt->run_steps( warmup_steps );
+	const uint64 setup_time = dr_time_us() - setup_start;
+
+	// the measured steps
+	freelist_t::reset_statistics();
+	step_profiler_t::reset_totals();
+	const uint64 run_start = dr_time_us();
+	welt->run_steps( steps );
+	const uint64 run_time = dr_time_us() - run_start;
+
+	uint32 subsystem_hashes[CHK_SUBSYSTEMS];
+	welt->calc_subsystem_hashes( subsystem_hashes, "benchmark", welt->get_steps() );
+	const uint32 gamestate_hash = welt->get_gamestate_hash();
+
+	uint64 citizens = 0;
+	for(stadt_t const* const city : welt->get_cities()) {
+		citizens += city->get_einwohner();
+	}
+
+	cbuffer_t buf;
+	buf.append( "{\n  \"benchmark\": " );
+	json_string( buf, name );
+	buf.printf( ",\n  \"version\": \"" VERSION_NUMBER EXTENDED_VERSION "\",\n  \"revision\": \"%s\",\n", QUOTEME(REVISION) );
+	buf.printf( "  \"pakset\": " );
+	json_string( buf, env_t::objfilename.c_str() );
+	buf.printf( ",\n  \"threads\": %u,\n", env_t::num_threads );
+	buf.printf( "  \"world\": { \"size_x\": %i, \"size_y\": %i, \"map_number\": %i, \"cities\": %u, \"citizens\": %llu, \"halts\": %u, \"convoys\": %u, \"factories\": %u },\n",
+		welt->get_size().x, welt->get_size().y, welt->get_settings().get_map_number(),
+		welt->get_cities().get_count(), (unsigned long long)citizens,
+		haltestelle_t::get_alle_haltestellen().get_count(), welt->convoys().get_count(), welt->get_fab_list().get_count() );
+	buf.printf( "  \"setup_s\": %.3f,\n  \"warmup_steps\": %u,\n  \"steps\": %u,\n  \"run_s\": %.3f,\n", setup_time / 1000000.0, warmup_steps, steps, run_time / 1000000.0 );
+
+	// mean and maximum over all measured steps, the 95th percentile over the last ones only
+	buf.append( "  \"phases_us\": {" );
+	const uint32 profiled_steps = step_profiler_t::get_total_steps();
+	for(  int p = 0;  p < step_profiler_t::MAX_PHASES;  p++  ) {
+		const step_profiler_t::phase_t phase = (step_profiler_t::phase_t)p;
+		uint64 total;
+		uint32 max, mean, p95, history_max;
+		step_profiler_t::get_totals( phase, total, max );
+		step_profiler_t::get_statistics( phase, mean, p95, history_max );
+		buf.printf( "%s\n    \"%s\": { \"total\": %llu, \"mean\": %.1f, \"p95\": %u, \"max\": %u }",
+			p ? "," : "", step_profiler_t::get_name(phase), (unsigned long long)total,
+			profiled_steps ? (double)total / profiled_steps : 0.0, p95, max );
+	}
+	buf.append( "\n  },\n" );
+
+	buf.printf( "  \"peak_memory_bytes\": %llu,\n", (unsigned long long)dr_get_peak_memory() );
+
+	freelist_t::stats_t stats[freelist_t::STATS_COUNT];
+	freelist_t::get_statistics( stats );
+	freelist_t::stats_t sum = freelist_t::stats_t();
+	for(  int i = 0;  i < freelist_t::STATS_COUNT;  i++  ) {
+		sum.allocs += stats[i].allocs;
+		sum.frees += stats[i].frees;
+		sum.refills += stats[i].refills;
+		sum.returns += stats[i].returns;
+		sum.contended += stats[i].contended;
+		sum.chunks += stats[i].chunks;
+	}
+	buf.printf( "  \"freelist\": { \"allocs\": %llu, \"frees\": %llu, \"refills\": %llu, \"returns\": %llu, \"contended\": %llu, \"chunks\": %u },\n",
+		(unsigned long long)sum.allocs, (unsigned long long)sum.frees, (unsigned long long)sum.refills,
+		(unsigned long long)sum.returns, (unsigned long long)sum.contended, sum.chunks );
+
+	buf.printf( "  \"hashes\": { \"gamestate\": \"%08x\"", gamestate_hash );
+	for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+		buf.printf( ", \"%s\": \"%08x\"", checklist_t::get_subsystem_name(i), subsystem_hashes[i] );
+	}
+	buf.append( " }\n}\n" );
+
+	if(  json_filename  ) {
+		FILE *f = dr_fopen( json_filename, "w" );
+		if(  !f  ) {
+			dbg->error( "benchmark_t::run()", "Cannot write benchmark result to \"%s\"", json_filename );
+			return false;
+		}
+		fputs( buf.get_str(), f );
+		fclose( f );
+	}
+	else {
+		printf( "%s", buf.get_str() );
+	}
+	dbg->message( "benchmark_t::run()", "%s", buf.get_str() );
+	return true;
+}
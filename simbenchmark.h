@@ -0,0 +1,42 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef SIMBENCHMARK_H
+#define SIMBENCHMARK_H
+
+
+#include "simtypes.h"
+
+class karte_t;
+
+
+/**
+ * Benchmark suite for tracking the performance of the simulation across commits.
+ *
+ * A benchmark either generates one of the built-in worlds from a fixed map
+ * number (so every run starts from the same world for the same pakset) or
+ * loads a savegame. Then it runs some warm up steps, and afterwards the
+ * measured steps headless at full speed (see karte_t::run_steps()).
+ *
+ * The result is written as JSON: the size of the world, the time per step
+ * phase (from step_profiler_t), peak memory, the allocations through the
+ * freelist and the state hashes of the world after the last step. Runs with
+ * the same parameters must end with the same hashes, anything else is a
+ * determinism bug.
+ */
+class benchmark_t
+{
+public:
+	/**
+	 * Runs the benchmark @p name: one of the built-in worlds
+	 * (small, medium, large) or else the savegame save/NAME.sve.
+	 * @param steps number of measured steps
+	 * @param json_filename result file, or NULL to print the result to stdout
+	 * @returns false, if the world could not be created or the result not written
+	 */
+	static bool run(karte_t *welt, const char *name, uint32 steps, const char *json_filename);
+};
+
+#endif
@@ -76,6 +76,7 @@
 #ifdef MULTI_THREAD
 #include "utils/simthread.h"
 static pthread_mutex_t step_convois_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t released_reservations_mutex = PTHREAD_MUTEX_INITIALIZER;
 static vector_tpl<pthread_t> unreserve_threads;
 waytype_t convoi_t::current_waytype = road_wt;
 uint16 convoi_t::current_unreserver = 0;
@@ -90,6 +91,12 @@ uint16 convoi_t::current_unreserver = 0;
  */
 #define WTT_LOADING 500
 
+/*
+ * Longest wait (ms) for clearance at a tile reserved by another convoi,
+ * if that convoi does not wake us before (see release_reservation_waiters())
+ */
+#define RESERVATION_WAIT_TIMEOUT 2500
+
 karte_ptr_t convoi_t::welt;
 
 /*
@@ -287,6 +294,10 @@ convoi_t::~convoi_t()
 	close_windows();
 
 DBG_MESSAGE("convoi_t::~convoi_t()", "destroying %d, %p", self.get_id(), this);
+	stop_waiting_for_reservation();
+	released_reservations.clear();
+	wake_reservation_waiters( koord3d::invalid );
+
 	// stop following
 	if(welt->get_viewport()->get_follow_convoi()==self) {
 		welt->get_viewport()->set_follow_convoi( convoihandle_t() );
@@ -410,6 +421,63 @@ void convoi_t::unreserve_route()
 #endif
 
 	set_needs_full_route_flush(false);
+	release_reservation_waiters( koord3d::invalid );
+}
+
+
+void convoi_t::wait_for_reservation(convoihandle_t blocker, koord3d pos)
+{
+	if(  reservation_wait_for!=blocker  ) {
+		stop_waiting_for_reservation();
+		blocker->reservation_waiters.append( self );
+		reservation_wait_for = blocker;
+	}
+	reservation_wait_pos = pos;
+}
+
+
+void convoi_t::stop_waiting_for_reservation()
+{
+	if(  reservation_wait_for.is_bound()  ) {
+		reservation_wait_for->reservation_waiters.remove( self );
+	}
+	reservation_wait_for = convoihandle_t();
+	reservation_wait_pos = koord3d::invalid;
+}
+
+
+void convoi_t::release_reservation_waiters(koord3d pos)
+{
+	if(  current_unreserver == self.get_id()  ) {
+		// called by the threads of unreserve_route(), which wakes all waiters afterwards
+		return;
+	}
+#ifdef MULTI_THREAD
+	pthread_mutex_lock( &released_reservations_mutex );
+#endif
+	released_reservations.append_unique( pos );
+#ifdef MULTI_THREAD
+	pthread_mutex_unlock( &released_reservations_mutex );
+#endif
+}
+
+
+void convoi_t::wake_reservation_waiters(koord3d pos)
+{
+	for(  uint32 i = 0;  i < reservation_waiters.get_count();  ) {
+		convoi_t *cnv = reservation_waiters[i].get_rep();
+		if(  pos!=koord3d::invalid  &&  cnv->reservation_wait_pos!=pos  ) {
+			i++;
+			continue;
+		}
+		reservation_waiters.remove_at( i );
+		cnv->reservation_wait_for = convoihandle_t();
+		cnv->reservation_wait_pos = koord3d::invalid;
+		if(  cnv->state==WAITING_FOR_CLEARANCE  ||  cnv->state==WAITING_FOR_CLEARANCE_ONE_MONTH  ||  cnv->state==WAITING_FOR_CLEARANCE_TWO_MONTHS  ) {
+			// try again in the next step
+			cnv->wait_lock = 0;
+		}
+	}
 }
 
 void convoi_t::reserve_own_tiles(bool unreserve)
@@ -490,6 +558,14 @@ uint32 convoi_t::move_to(uint16 const start_index)
 
 void convoi_t::finish_rd()
 {
+	if(  reservation_wait_for.is_bound()  ) {
+		reservation_wait_for->reservation_waiters.append( self );
+	}
+	else {
+		reservation_wait_for = convoihandle_t();
+		reservation_wait_pos = koord3d::invalid;
+	}
+
 	if(schedule==NULL) {
 		if(  state!=INITIAL  ) {
 			emergency_go_to_depot();
@@ -710,6 +786,14 @@ void convoi_t::rotate90( const sint16 y_size )
 {
 	home_depot.rotate90( y_size );
 	last_signal_pos.rotate90(y_size);
+	if(  reservation_wait_pos!=koord3d::invalid  ) {
+		reservation_wait_pos.rotate90( y_size );
+	}
+	for(koord3d &pos : released_reservations) {
+		if(  pos!=koord3d::invalid  ) {
+			pos.rotate90( y_size );
+		}
+	}
 	route.rotate90( y_size );
 	if(  schedule_target!=koord3d::invalid  ) {
 		schedule_target.rotate90( y_size );
@@ -1354,8 +1438,19 @@ sync_result convoi_t::sync_step(uint32 delta_t)
 					return SYNC_REMOVE;
 				}
 				// now move the rest (so all vehikel are moving synchronously)
-				for(unsigned i=1; i<vehicle_count; i++) {
-					vehicle[i]->do_drive(max(1,sp_hat));
+				// Most of the time none of them leaves its tile, then just advance
+				// their steps; only the tile crossings need the full do_drive().
+				const uint32 steps_hat = sp_hat >> YARDS_PER_VEHICLE_STEP_SHIFT;
+				if(  steps_hat > 0  ) {
+					for(unsigned i=1; i<vehicle_count; i++) {
+						vehicle_t *v = vehicle[i];
+						if(  v->get_steps() + steps_hat <= v->get_steps_next()  ) {
+							v->move_on_tile( steps_hat );
+						}
+						else {
+							v->do_drive( sp_hat );
+						}
+					}
 				}
 				// maybe we have been stopped be something => avoid wide jumps
 				sp_soll = (sp_soll-sp_hat) & 0x0FFF;
@@ -1773,6 +1868,12 @@ void convoi_t::threaded_step()
  */
 void convoi_t::step()
 {
+	// the convoi threads have finished, now the waiters can be changed
+	for(koord3d const& pos : released_reservations) {
+		wake_reservation_waiters( pos );
+	}
+	released_reservations.clear();
+
 	if(wait_lock !=0)
 	{
 		return;
@@ -2292,8 +2393,17 @@ end_loop:
 					front()->set_convoi(this);
 				}
 
+				reservation_blocker = convoihandle_t();
 				if (front()->can_enter_tile(restart_speed,0)) {
 					state = (steps_driven>=0) ? LEAVING_DEPOT : DRIVING;
+					stop_waiting_for_reservation();
+				}
+				else if(  reservation_blocker.is_bound()  &&  reservation_blocker!=self  ) {
+					// no need to try again before this reservation is released
+					wait_for_reservation( reservation_blocker, reservation_blocker_pos );
+				}
+				else {
+					stop_waiting_for_reservation();
 				}
 				if(restart_speed>=0) {
 					set_akt_speed(restart_speed);
@@ -2404,6 +2514,10 @@ end_loop:
 			// action soon needed
 			// Bernd Gabriel: simutrans extended may have presets the wait_lock before. Don't overwrite it here, if it ought to wait longer.
 			wait_lock = max(wait_lock, 250);
+			if(  state==WAITING_FOR_CLEARANCE  &&  reservation_wait_for.is_bound()  ) {
+				// will be woken when the reservation is released
+				wait_lock = max(wait_lock, RESERVATION_WAIT_TIMEOUT);
+			}
 			break;
 
 		// waiting for free way, not too heavy, not to slow
@@ -5129,6 +5243,22 @@ void convoi_t::rdwr(loadsave_t *file)
 	{
 		checked_tile_this_step.rdwr(file);
 	}
+	if(  file->is_version_ex_atleast(14, 67)  ) {
+		// the lists of waiters are restored in finish_rd()
+		rdwr_convoihandle_t( file, reservation_wait_for );
+		reservation_wait_pos.rdwr( file );
+	}
+	if(  file->is_version_ex_atleast(14, 70)  ) {
+		uint32 count = released_reservations.get_count();
+		file->rdwr_long( count );
+		for(  uint32 i = 0;  i < count;  i++  ) {
+			koord3d pos = file->is_saving() ? released_reservations[i] : koord3d::invalid;
+			pos.rdwr( file );
+			if(  file->is_loading()  ) {
+				released_reservations.append( pos );
+			}
+		}
+	}
 	if (file->is_version_ex_less(14, 64)) {
 		owner->book_convoy_distance(financial_history[0][CONVOI_DISTANCE], front()->get_waytype(), vehicle_count);
 	}
@@ -709,6 +709,34 @@ private:
 	// more than once in a step on the same tile
 	koord3d checked_tile_this_step = koord3d::invalid;
 
+	/**
+	 * If waiting for clearance at a tile reserved by another convoi, this
+	 * convoi is registered with it (in its reservation_waiters) and only
+	 * retries when that convoi releases the tile or the whole route, or
+	 * else after a longer timeout. Saved, so clients wake the same convois.
+	 */
+	convoihandle_t reservation_wait_for;
+	koord3d reservation_wait_pos = koord3d::invalid;
+
+	// convois waiting for tiles reserved by this convoi
+	vector_tpl<convoihandle_t> reservation_waiters;
+
+	/**
+	 * Released tiles (koord3d::invalid for all) whose waiters are woken in
+	 * the next step(): tiles are also released in the threads of the convois,
+	 * which must not change other convois. Saved.
+	 */
+	vector_tpl<koord3d> released_reservations;
+
+	// first tile reserved by another convoi which stopped rail_vehicle_t::block_reserver()
+	convoihandle_t reservation_blocker;
+	koord3d reservation_blocker_pos = koord3d::invalid;
+
+	void wait_for_reservation(convoihandle_t blocker, koord3d pos);
+	void stop_waiting_for_reservation();
+	/// wakes the waiters for @p pos now, only from the main thread outside of the convoi threads
+	void wake_reservation_waiters(koord3d pos);
+
 
 public:
 	/**
@@ -1405,6 +1433,23 @@ public:
 	koord3d get_checked_tile_this_step() const { return checked_tile_this_step; }
 	void set_checked_tile_this_step(koord3d value) { checked_tile_this_step = value; }
 
+	// called by rail_vehicle_t::block_reserver(), if pos is reserved by another convoi
+	void set_reservation_blocker(convoihandle_t blocker, koord3d pos)
+	{
+		if(  !reservation_blocker.is_bound()  ) {
+			reservation_blocker = blocker;
+			reservation_blocker_pos = pos;
+		}
+	}
+
+	/**
+	 * Wakes the convois waiting for the reservation of @p pos by this convoi,
+	 * or all convois waiting for this convoi if @p pos is koord3d::invalid.
+	 * Called by schiene_t::unreserve() for every released tile, also from the
+	 * convoi threads, hence the waiters are only woken in the next step().
+	 */
+	void release_reservation_waiters(koord3d pos);
+
 	/**
 	 * Calculate the number of tiles over which this convoy
 	 * needs to check for corner radii based on its maximum
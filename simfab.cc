@@ -839,6 +839,7 @@ fabrik_t::fabrik_t(loadsave_t* file) :
 	delta_t_sum = 0;
 	delta_amount = 0;
 	delta_amount_remainder = 0;
+	distribution_due = false;
 	total_input = total_transit = total_output = 0;
 	sector = unknown;
 	status = nothing;
@@ -894,6 +895,7 @@ fabrik_t::fabrik_t(koord3d pos_, player_t* owner, const factory_desc_t* desc, si
 	delta_t_sum = 0;
 	delta_amount = 0;
 	delta_amount_remainder = 0;
+	distribution_due = false;
 	activity_count = 0;
 	currently_producing = false;
 	transformer_connected = NULL;
@@ -2301,6 +2303,25 @@ void fabrik_t::remove_contracts(){
 }
 
 void fabrik_t::step(uint32 delta_t)
+{
+	if(welt->get_settings().using_fab_contracts()){
+		if(!has_calculated_intransit_percentages)
+		{
+			calc_max_intransit_percentages();
+		}
+		if(  delta_t>0  ) {
+			step_contracts(delta_t);
+		}
+		return;
+	}
+
+	step_production(delta_t);
+	plan_distribution();
+	distribute();
+}
+
+
+void fabrik_t::step_production(uint32 delta_t)
 {
 	if(!has_calculated_intransit_percentages)
 	{
@@ -2313,11 +2334,6 @@ void fabrik_t::step(uint32 delta_t)
 		return;
 	}
 
-	if(welt->get_settings().using_fab_contracts()){
-		step_contracts(delta_t);
-		return;
-	}
-
 	// produce nothing/consumes nothing ...
 	if(  input.empty()  &&  output.empty()  ) {
 		// power station? => produce power
@@ -2521,26 +2537,50 @@ void fabrik_t::step(uint32 delta_t)
 	delta_t_sum += delta_t;
 	if(  delta_t_sum > PRODUCTION_DELTA_T  ) {
 		delta_t_sum = delta_t_sum % PRODUCTION_DELTA_T;
+		distribution_due = true;
+	}
+
+	advance_slot(delta_t);
+}
+
+
+void fabrik_t::plan_distribution()
+{
+	pending_deliveries.clear();
+	if(  !distribution_due  ) {
+		return;
+	}
 
-		// distribute, if there is more than 1 waiting ...
-		// Changed from the original 10 by jamespetts, July 2017
-		for(  uint32 product = 0;  product < output.get_count();  product++  )
+	// distribute, if there is more than 1 waiting ...
+	// Changed from the original 10 by jamespetts, July 2017
+	for(  uint32 product = 0;  product < output.get_count();  product++  )
+	{
+		const sint32 units = (sint32)(((sint64)output[product].menge * (sint64)(get_prodfactor())) >> ((sint64)DEFAULT_PRODUCTION_FACTOR_BITS + (sint64)precision_bits));
+		//if(  output[product].menge > (1 << precision_bits)  ||  output[product].menge*2 > output[product].max  )
+		if(units)
 		{
-			const sint32 units = (sint32)(((sint64)output[product].menge * (sint64)(get_prodfactor())) >> ((sint64)DEFAULT_PRODUCTION_FACTOR_BITS + (sint64)precision_bits));
-			//if(  output[product].menge > (1 << precision_bits)  ||  output[product].menge*2 > output[product].max  )
-			if(units)
-			{
-				verteile_waren(product);
-				INT_CHECK("simfab 636");
-			}
+			plan_delivery(product);
 		}
+	}
+}
 
-		recalc_factory_status();
 
-		rescale_delta();
+void fabrik_t::distribute()
+{
+	if(  !distribution_due  ) {
+		return;
 	}
+	distribution_due = false;
 
-	advance_slot(delta_t);
+	for(pending_delivery_t &delivery : pending_deliveries) {
+		verteile_waren(delivery);
+		INT_CHECK("simfab 636");
+	}
+	pending_deliveries.clear();
+
+	recalc_factory_status();
+
+	rescale_delta();
 }
 
 
@@ -2848,9 +2888,9 @@ public:
 
 
 /**
- * distribute stuff to all best destination
+ * find the best destination for the stuff
  */
-void fabrik_t::verteile_waren(const uint32 product)
+void fabrik_t::plan_delivery(const uint32 product)
 {
 	// Check consumers
 	if(  !get_output()[product].link_count()  )
@@ -2858,8 +2898,8 @@ void fabrik_t::verteile_waren(const uint32 product)
 		return;
 	}
 
-	static vector_tpl<distribute_ware_t> dist_list(16);
-	dist_list.clear();
+	// not static: this may run for several factories at once
+	vector_tpl<distribute_ware_t> dist_list(16);
 
 	// to distribute to all target equally, we use this counter, for the source hald, and target factory, to try first
 	output[product].index_offset++;
@@ -3030,67 +3070,105 @@ void fabrik_t::verteile_waren(const uint32 product)
 			return; // no route for any destination
 		}
 
-		halthandle_t &best_halt = best->nearby_halt.halt;
-		ware_t       &best_ware = best->ware;
-
-		// now process found route
-		const sint32 space_left = best_halt.is_bound() ? welt->get_settings().get_just_in_time() ? best->space_left : (sint32)best_halt->get_capacity(2) - (sint32)best_halt->get_ware_summe(best_ware.get_desc()) : needed_base_units;
-		menge = min(menge, space_left);
-		// ensure amount is not negative ...
-		if(  menge<0  ) {
-			menge = 0;
-		}
-		// since it is assigned here to an unsigned variable!
-		best_ware.menge = menge;
-
-		if(  space_left<0 && best_halt.is_bound()  ) {
-			// find, what is most waiting here from us
-			ware_t most_waiting(output[product].get_typ());
-			most_waiting.menge = 0;
-			for(auto const & consumer_pos : consumers) {
-				uint32 const amount = best_halt->get_ware_fuer_zielpos(output[product].get_typ(), consumer_pos);
-				if(  amount > most_waiting.menge  ) {
-					most_waiting.set_zielpos(consumer_pos);
-					most_waiting.menge = amount;
-					most_waiting.arrival_time = welt->get_ticks();
-				}
+		pending_delivery_t delivery;
+		delivery.product = product;
+		delivery.ware = best->ware;
+		delivery.nearby_halt = best->nearby_halt;
+		delivery.space_left = best->nearby_halt.halt.is_bound() ? best->space_left : needed_base_units;
+		delivery.amount_waiting = best->amount_waiting;
+		pending_deliveries.append(delivery);
+	}
+}
+
+
+/**
+ * distribute stuff to the planned destination
+ */
+void fabrik_t::verteile_waren(pending_delivery_t &delivery)
+{
+	const uint32 product = delivery.product;
+	const uint32 prod_factor = desc->get_product(product)->get_factor();
+	halthandle_t &best_halt = delivery.nearby_halt.halt;
+	ware_t       &best_ware = delivery.ware;
+	sint32 menge = best_ware.menge;
+
+	// the factories handed over before may have covered the demand of the consumer since planning
+	const fabrik_t *consumer = get_fab(best_ware.get_zielpos());
+	if(  consumer == NULL  ) {
+		return;
+	}
+	const sint32 needed = consumer->goods_needed(best_ware.get_desc());
+	const bool just_in_time = welt->get_settings().get_just_in_time() != 0;
+	if(  needed < 0  ||  (just_in_time  &&  needed == 0)  ) {
+		return;
+	}
+
+	// now process found route; the factories before may have filled the halt since planning
+	sint32 space_left = delivery.space_left;
+	if(  just_in_time  ) {
+		// at least one unit, as when planning
+		const sint32 needed_base_units = (sint32)(((sint64)needed * (sint64)(prod_factor)) >> (DEFAULT_PRODUCTION_FACTOR_BITS + precision_bits));
+		space_left = min(space_left, max(needed_base_units, 1));
+	}
+	if(  best_halt.is_bound()  ) {
+		const sint32 halt_left = (sint32)best_halt->get_capacity(2) - (sint32)best_halt->get_ware_summe(best_ware.get_desc());
+		space_left = just_in_time ? min(space_left, halt_left) : halt_left;
+	}
+	menge = min(menge, space_left);
+	// ensure amount is not negative ...
+	if(  menge<0  ) {
+		menge = 0;
+	}
+	// since it is assigned here to an unsigned variable!
+	best_ware.menge = menge;
+
+	if(  space_left<0 && best_halt.is_bound()  ) {
+		// find, what is most waiting here from us
+		ware_t most_waiting(output[product].get_typ());
+		most_waiting.menge = 0;
+		for(auto const & consumer_pos : consumers) {
+			uint32 const amount = best_halt->get_ware_fuer_zielpos(output[product].get_typ(), consumer_pos);
+			if(  amount > most_waiting.menge  ) {
+				most_waiting.set_zielpos(consumer_pos);
+				most_waiting.menge = amount;
+				most_waiting.arrival_time = welt->get_ticks();
 			}
+		}
 
-			//  we will reroute some goods
-			if(  best->amount_waiting==0  &&  most_waiting.menge>0  ) {
-				// remove something from the most waiting goods
-				if(  best_halt->recall_ware( most_waiting, min((sint32)(most_waiting.menge/2), 1 - space_left) )  ) {
-					best_ware.menge += most_waiting.menge;
-				}
-				else {
-					// overcrowded with other stuff (not from us)
-					return;
-				}
+		//  we will reroute some goods
+		if(  delivery.amount_waiting==0  &&  most_waiting.menge>0  ) {
+			// remove something from the most waiting goods
+			if(  best_halt->recall_ware( most_waiting, min((sint32)(most_waiting.menge/2), 1 - space_left) )  ) {
+				best_ware.menge += most_waiting.menge;
 			}
 			else {
+				// overcrowded with other stuff (not from us)
 				return;
 			}
 		}
+		else {
+			return;
+		}
+	}
 
-		// Since menge might have been mutated, it must be converted back. This might introduce some error with some prod factors which is always rounded up.
-		const sint32 prod_delta = ((((sint64)menge << (DEFAULT_PRODUCTION_FACTOR_BITS + precision_bits)) + (sint64)(prod_factor - 1)) / (sint64)prod_factor);
+	// Since menge might have been mutated, it must be converted back. This might introduce some error with some prod factors which is always rounded up.
+	const sint32 prod_delta = ((((sint64)menge << (DEFAULT_PRODUCTION_FACTOR_BITS + precision_bits)) + (sint64)(prod_factor - 1)) / (sint64)prod_factor);
 
-		output[product].menge -= prod_delta;
+	output[product].menge -= prod_delta;
 
-		if (best_halt.is_bound())
-		{
-			best_halt->starte_mit_route(best_ware, get_pos().get_2d());
-			best_halt->recalc_status();
-		}
-		else
-		{
-			world()->add_to_waiting_list(best_ware, get_pos().get_2d());
-		}
-		fabrik_t::update_transit( best_ware, true );
-		// add as active destination
-		set_consumer_active_at(best_ware.get_zielpos());
-		output[product].book_stat(best_ware.menge, FAB_GOODS_DELIVERED);
+	if (best_halt.is_bound())
+	{
+		best_halt->starte_mit_route(best_ware, get_pos().get_2d());
+		best_halt->recalc_status();
+	}
+	else
+	{
+		world()->add_to_waiting_list(best_ware, get_pos().get_2d());
 	}
+	fabrik_t::update_transit( best_ware, true );
+	// add as active destination
+	set_consumer_active_at(best_ware.get_zielpos());
+	output[product].book_stat(best_ware.menge, FAB_GOODS_DELIVERED);
 }
 
 stadt_t* fabrik_t::check_local_city()
@@ -154,7 +154,7 @@ public:
 	/// Current limit on cargo in transit, depending on suppliers mean distance.
 	sint32 max_transit;
 
-	uint32 index_offset; // used for haltlist and consumers searches in verteile_waren to produce round robin results
+	uint32 index_offset; // used for haltlist and consumers searches in plan_delivery to produce round robin results
 
 	const vector_tpl<koord>& get_links() const {return links;}
 
@@ -570,10 +570,33 @@ private:
 	};
 	vector_tpl <field_data_t> fields;
 
+	/**
+	 * A delivery chosen by plan_delivery(). It is only carried out
+	 * by distribute() on the main thread, in the order of the factory list.
+	 */
+	struct pending_delivery_t
+	{
+		uint32 product;
+		ware_t ware;                /// goods routed to the consumer
+		nearby_halt_t nearby_halt;  /// start halt (unbound when carting)
+		sint32 space_left;          /// space planned for (just in time mode and carting)
+		sint32 amount_waiting;      /// goods waiting at the halt for the same consumer
+	};
+	vector_tpl<pending_delivery_t> pending_deliveries;
+
+	/// set by step_production() when the goods are to be distributed in this step
+	bool distribution_due;
+
+	/**
+	 * Chooses the best destination and start halt for the goods of @p product.
+	 * Only reads the other factories and the halts.
+	 */
+	void plan_delivery(const uint32 product);
+
 	/**
 	 * The produced were distributed at the stops
 	 */
-	void verteile_waren(const uint32 product);
+	void verteile_waren(pending_delivery_t &delivery);
 
 	player_t *owner;
 	static karte_ptr_t welt;
@@ -954,6 +977,17 @@ public:
 	bool out_of_stock_selective();
 
 	void step(uint32 delta_t);                  // factory muss auch arbeiten ("factory must also work")
+
+	/**
+	 * The stages of step() without contracts. karte_t::step_factories() runs
+	 * each of them for all factories before the next one: step_production()
+	 * and plan_distribution() change nothing but this factory and may run in
+	 * parallel, distribute() delivers the planned goods on the main thread.
+	 */
+	void step_production(uint32 delta_t);
+	void plan_distribution();
+	void distribute();
+
 	void step_contracts(uint32 delta_t);
 
 	void distribute_contracts(uint32 delta_t);
@@ -50,6 +50,7 @@
 #include "gui/halt_detail.h"
 #include "gui/minimap.h"
 
+#include "utils/checklist.h"
 #include "utils/simrandom.h"
 #include "utils/simstring.h"
 
@@ -62,12 +63,16 @@ karte_ptr_t haltestelle_t::welt;
 
 vector_tpl<halthandle_t> haltestelle_t::alle_haltestellen;
 
+uint32 haltestelle_t::month_step_index = haltestelle_t::MONTH_STEP_DONE;
+
+uint32 haltestelle_t::history_epoch = 0;
+
 stringhashtable_tpl<halthandle_t, N_BAGS_LARGE> haltestelle_t::all_names;
 
 vector_tpl<lines_loaded_t> haltestelle_t::lines_loaded;
 
 // hash table only used during loading
-inthashtable_tpl<sint32,halthandle_t,N_BAGS_LARGE> *haltestelle_t::all_koords = NULL;
+flat_inthashtable_tpl<sint32,halthandle_t> *haltestelle_t::all_koords = NULL;
 // since size_x*size_y < 0x1000000, we have just to shift the high bits
 #define get_halt_key(k,width) ( ((k).x*(width)+(k).y) /*+ ((k).z << 25)*/ )
 
@@ -103,7 +108,7 @@ static vector_tpl<linehandle_t>stale_lines;
 
 void haltestelle_t::start_load_game()
 {
-	all_koords = new inthashtable_tpl<sint32,halthandle_t,N_BAGS_LARGE>;
+	all_koords = new flat_inthashtable_tpl<sint32,halthandle_t>;
 }
 
 
@@ -378,10 +383,111 @@ void haltestelle_t::destroy_all()
 	}
 	delete all_koords;
 	all_koords = NULL;
+	month_step_index = MONTH_STEP_DONE;
 	//status_step = 0;
 }
 
 
+void haltestelle_t::step_month(bool finish)
+{
+	const uint32 count = alle_haltestellen.get_count();
+	if(  month_step_index >= count  ) {
+		month_step_index = MONTH_STEP_DONE;
+		return;
+	}
+
+	const uint32 end_index = finish ? count : min( count, month_step_index + max( 64u, count / 64 ) );
+	while(  month_step_index < end_index  ) {
+		alle_haltestellen[month_step_index]->age_waiting_times();
+		month_step_index++;
+	}
+
+	if(  month_step_index >= count  ) {
+		month_step_index = MONTH_STEP_DONE;
+	}
+}
+
+
+void haltestelle_t::rdwr_month_step(loadsave_t *file)
+{
+	if(  file->is_version_ex_atleast(14, 68)  ) {
+		file->rdwr_long( month_step_index );
+	}
+	else if(  file->is_loading()  ) {
+		month_step_index = MONTH_STEP_DONE;
+	}
+}
+
+
+// run the same workload through one table type: build a table for every connexion table,
+// then look up every key (hits) and every key of the next table (mostly misses)
+template<class table_t>
+static void time_connexion_tables(const vector_tpl<vector_tpl<halthandle_t> *> &keys, uint32 rounds, uint64 &insert_us, uint64 &lookup_us, uint32 &found)
+{
+	insert_us = lookup_us = 0;
+	found = 0;
+	vector_tpl<table_t *> tables( keys.get_count() );
+	for(  uint32 r = 0;  r < rounds;  r++  ) {
+		const uint64 t0 = dr_time_us();
+		FOR( vector_tpl<vector_tpl<halthandle_t> *>, const k, keys ) {
+			table_t *table = new table_t();
+			FOR( vector_tpl<halthandle_t>, const h, *k ) {
+				table->put( h, NULL );
+			}
+			tables.append( table );
+		}
+		const uint64 t1 = dr_time_us();
+		for(  uint32 i = 0;  i < tables.get_count();  i++  ) {
+			for(  uint32 j = i;  j <= i+1  &&  j < keys.get_count();  j++  ) {
+				FOR( vector_tpl<halthandle_t>, const h, *keys[j] ) {
+					found += tables[i]->is_contained( h );
+				}
+			}
+		}
+		const uint64 t2 = dr_time_us();
+		clear_ptr_vector( tables );
+		insert_us += t1 - t0;
+		lookup_us += t2 - t1;
+	}
+}
+
+
+void haltestelle_t::benchmark_connexion_tables(cbuffer_t &buf)
+{
+	vector_tpl<vector_tpl<halthandle_t> *> keys;
+	uint32 entries = 0;
+	FOR( vector_tpl<halthandle_t>, const halt, alle_haltestellen ) {
+		for(  uint8 catg = 0;  catg < halt->connexions.get_count();  catg++  ) {
+			for(  uint8 g_class = 0;  g_class < halt->connexions[catg].get_count();  g_class++  ) {
+				const connexions_map *cxns = halt->connexions[catg][g_class];
+				if(  cxns->empty()  ) {
+					continue;
+				}
+				vector_tpl<halthandle_t> *k = new vector_tpl<halthandle_t>( cxns->get_count() );
+				FOR( connexions_map, const& iter, *cxns ) {
+					k->append( iter.key );
+				}
+				entries += k->get_count();
+				keys.append( k );
+			}
+		}
+	}
+
+	const uint32 rounds = 20;
+	uint64 bag_insert, bag_lookup, flat_insert, flat_lookup;
+	uint32 bag_found, flat_found;
+	time_connexion_tables< quickstone_hashtable_tpl<haltestelle_t, connexion *, N_BAGS_MEDIUM> >( keys, rounds, bag_insert, bag_lookup, bag_found );
+	time_connexion_tables< connexions_map >( keys, rounds, flat_insert, flat_lookup, flat_found );
+	buf.printf( "Connexion tables: %u tables with %u entries, %u rounds\n", keys.get_count(), entries, rounds );
+	clear_ptr_vector( keys );
+	buf.printf( "  hashtable_tpl:      insert %.3f ms, lookup %.3f ms\n", bag_insert / 1000.0, bag_lookup / 1000.0 );
+	buf.printf( "  flat_hashtable_tpl: insert %.3f ms, lookup %.3f ms\n", flat_insert / 1000.0, flat_lookup / 1000.0 );
+	if(  bag_found != flat_found  ) {
+		dbg->error( "haltestelle_t::benchmark_connexion_tables", "Tables disagree: %u found in hashtable_tpl, %u in flat_hashtable_tpl", bag_found, flat_found );
+	}
+}
+
+
 haltestelle_t::haltestelle_t(loadsave_t* file)
 {
 	// NOTE: This is not called when saving.
@@ -538,8 +644,15 @@ haltestelle_t::~haltestelle_t()
 
 	// first: remove halt from all lists
 	int i=0;
-	while(alle_haltestellen.remove(self)) {
-		i++;
+	for(  uint32 n = alle_haltestellen.get_count();  n-- > 0;  ) {
+		if(  alle_haltestellen[n] == self  ) {
+			alle_haltestellen.remove_at(n);
+			// keep the pending monthly upkeep at the same halt
+			if(  n < month_step_index  &&  month_step_index != MONTH_STEP_DONE  ) {
+				month_step_index--;
+			}
+			i++;
+		}
 	}
 	if (i != 1) {
 		dbg->error("haltestelle_t::~haltestelle_t()", "handle %i found %i times in haltlist!", self.get_id(), i );
@@ -1470,6 +1583,14 @@ void haltestelle_t::new_month()
 		enables &= (PAX|POST|WARE);
 	}
 
+	// the financial history was rolled by new_history_month()
+	// number of waitung should be constant ...
+	financial_history.set( 0, HALT_WAITING, get_finance_history( 1, HALT_WAITING ), history_epoch );
+}
+
+
+void haltestelle_t::age_waiting_times()
+{
 	// If the waiting times have not been updated for too long, gradually re-set them; also increment the timing records.
 	for (uint8 category = 0; category < goods_manager_t::get_max_catg_index(); category++)
 	{
@@ -1518,16 +1639,6 @@ void haltestelle_t::new_month()
 	}
 
 	check_nearby_halts();
-
-	// roll financial history
-	for (int j = 0; j<MAX_HALT_COST; j++) {
-		for (int k = MAX_MONTHS-1; k>0; k--) {
-			financial_history[k][j] = financial_history[k-1][j];
-		}
-		financial_history[0][j] = 0;
-	}
-	// number of waitung should be constant ...
-	financial_history[0][HALT_WAITING] = financial_history[1][HALT_WAITING];
 }
 
 
@@ -1774,7 +1885,7 @@ sint8 haltestelle_t::is_connected(halthandle_t halt, uint8 catg_index) const
 
 uint32 haltestelle_t::get_average_waiting_time(halthandle_t halt, uint8 category, uint8 g_class)
 {
-	inthashtable_tpl<uint32, haltestelle_t::waiting_time_set, N_BAGS_SMALL> * const wt = waiting_times[category][g_class];
+	waiting_time_map * const wt = waiting_times[category][g_class];
 	if(wt->is_contained((halt.get_id())))
 	{
 		fixed_list_tpl<uint32, 32> times = waiting_times[category][g_class]->get(halt.get_id()).times;
@@ -2899,7 +3010,7 @@ sint64 haltestelle_t::get_overcrowded_proporion(uint8 typ) const
 			waiting_amount_of_this_typ = get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_MAIL));
 			break;
 		case 2:
-			waiting_amount_of_this_typ = financial_history[0][HALT_WAITING] - get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_PAS)) - get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_MAIL));
+			waiting_amount_of_this_typ = get_finance_history(0, HALT_WAITING) - get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_PAS)) - get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_MAIL));
 			break;
 		default:
 			return 0; // error
@@ -2922,6 +3033,25 @@ uint32 haltestelle_t::get_ware_summe(const goods_desc_t *wtyp) const
 	return sum;
 }
 
+uint32 haltestelle_t::get_cargo_hash() const
+{
+	uint32 hash = checklist_hash_add(CHK_HASH_INIT, self.get_id());
+	for(  uint8 catg = 0;  catg < goods_manager_t::get_max_catg_index();  catg++  ) {
+		const vector_tpl<ware_t> *warray = cargo[catg];
+		if(  warray == NULL  ) {
+			continue;
+		}
+		hash = checklist_hash_add(hash, warray->get_count());
+		for(ware_t const& ware : *warray) {
+			hash = checklist_hash_add(hash, ware.menge);
+			hash = checklist_hash_add(hash, ware.get_index());
+			hash = checklist_hash_add(hash, ware.get_ziel().get_id());
+			hash = checklist_hash_add(hash, ware.get_zwischenziel().get_id());
+		}
+	}
+	return hash;
+}
+
 uint32 haltestelle_t::get_ware_summe(const goods_desc_t *wtyp, uint8 wealth_class, bool chk_only_commuter) const
 {
 	if (wealth_class >= wtyp->get_number_of_classes()) {
@@ -3668,8 +3798,8 @@ bool haltestelle_t::make_public_and_join(player_t *player)
 			// add statistics
 			for(  int month=0;  month<MAX_MONTHS;  month++  ) {
 				for(  int type=0;  type<MAX_HALT_COST;  type++  ) {
-					financial_history[month][type] += halt->financial_history[month][type];
-					halt->financial_history[month][type] = 0;	// to avoid counting twice
+					financial_history.set( month, type, get_finance_history( month, type ) + halt->get_finance_history( month, type ), history_epoch );
+					halt->financial_history.set( month, type, 0, history_epoch );	// to avoid counting twice
 				}
 			}
 
@@ -4130,10 +4260,12 @@ void haltestelle_t::rdwr(loadsave_t *file)
 			}
 			for (int k = MAX_MONTHS - 1; k >= 0; k--)
 			{
-				file->rdwr_longlong(financial_history[k][j]);
+				sint64 value = get_finance_history(k, j);
+				file->rdwr_longlong(value);
 				if (file->is_version_ex_less(14,49) && j== HALT_COMMUTERS && file->is_loading()) {
-					financial_history[k][j] = 0;
+					value = 0;
 				}
+				financial_history.set(k, j, value, history_epoch);
 			}
 		}
 	}
@@ -4159,7 +4291,9 @@ void haltestelle_t::rdwr(loadsave_t *file)
 				}
 				else
 				{
-					file->rdwr_longlong(financial_history[k][j]);
+					sint64 value = get_finance_history(k, j);
+					file->rdwr_longlong(value);
+					financial_history.set(k, j, value, history_epoch);
 				}
 			}
 		}
@@ -4168,7 +4302,7 @@ void haltestelle_t::rdwr(loadsave_t *file)
 			if( file->is_loading() ) {
 				for( uint8 l = HALT_TOO_SLOW; l<MAX_HALT_COST; l++ )
 				{
-					financial_history[k][l] = 0;
+					financial_history.set(k, l, 0, history_epoch);
 				}
 			}
 		}
@@ -4937,23 +5071,28 @@ void haltestelle_t::finish_rd(bool need_recheck_for_walking_distance)
 void haltestelle_t::book(sint64 amount, int cost_type)
 {
 	assert(cost_type <= MAX_HALT_COST);
-	financial_history[0][cost_type] += amount;
+	financial_history.book( cost_type, amount, history_epoch );
 }
 
 
-
-void haltestelle_t::init_financial_history()
+void haltestelle_t::get_finance_history(sint64 *dest) const
 {
-	for (int j = 0; j<MAX_HALT_COST; j++)
-	{
-		for (size_t k = MAX_MONTHS; k-- != 0;) {
-			financial_history[k][j] = 0;
+	for(  int k = 0;  k < MAX_MONTHS;  k++  ) {
+		for(  int j = 0;  j < MAX_HALT_COST;  j++  ) {
+			*dest++ = get_finance_history( k, j );
 		}
 	}
 }
 
 
 
+void haltestelle_t::init_financial_history()
+{
+	financial_history.clear( history_epoch );
+}
+
+
+
 /**
  * Calculates a status color for status bars
  */
@@ -4964,7 +5103,7 @@ void haltestelle_t::recalc_status()
 		status_color = COL_INACTIVE;
 		return;
 	}
-	status_color = color_idx_to_rgb( financial_history[0][HALT_CONVOIS_ARRIVED] > 0 ? COL_GREEN : COL_YELLOW );
+	status_color = color_idx_to_rgb( get_finance_history(0, HALT_CONVOIS_ARRIVED) > 0 ? COL_GREEN : COL_YELLOW );
 
 	// since the status is ordered ...
 	uint8 status_bits = 0;
@@ -5038,7 +5177,7 @@ void haltestelle_t::recalc_status()
 		if (!has_active_freight_connection && status_color_freight != COL_CLEAR) {
 			status_color_freight = COL_INACTIVE;
 		}
-		else if (!total_freight && !transferring_total && financial_history[0][HALT_GOODS_HANDLING_VOLUME]==0) {
+		else if (!total_freight && !transferring_total && get_finance_history(0, HALT_GOODS_HANDLING_VOLUME)==0) {
 			status_color_freight = COL_CAUTION;
 		}
 		else if(status_color_freight != SYSCOL_OVERCROWDED) {
@@ -5053,7 +5192,7 @@ void haltestelle_t::recalc_status()
 	}
 	else
 	{
-		const sint64 total_usage_this_month = financial_history[0][HALT_VISITORS] + financial_history[0][HALT_COMMUTERS]+ financial_history[0][HALT_MAIL_HANDLING_VOLUME] + financial_history[0][HALT_GOODS_HANDLING_VOLUME];
+		const sint64 total_usage_this_month = get_finance_history(0, HALT_VISITORS) + get_finance_history(0, HALT_COMMUTERS)+ get_finance_history(0, HALT_MAIL_HANDLING_VOLUME) + get_finance_history(0, HALT_GOODS_HANDLING_VOLUME);
 		status_color = color_idx_to_rgb( (total_usage_this_month+total_sum == 0) ? COL_YELLOW : COL_GREEN );
 	}
 
@@ -5062,7 +5201,7 @@ void haltestelle_t::recalc_status()
 		status_color = color_idx_to_rgb(COL_PURPLE);
 	}
 
-	financial_history[0][HALT_WAITING] = total_sum;
+	financial_history.set( 0, HALT_WAITING, total_sum, history_epoch );
 }
 
 
@@ -6635,12 +6774,12 @@ bool haltestelle_t::has_pax_user(const uint8 months, bool demand_check) const {
 		if (i >= MAX_MONTHS) {
 			break;
 		}
-		count += financial_history[i][HALT_HAPPY];
-		count += financial_history[i][HALT_UNHAPPY];
-		count += financial_history[i][HALT_TOO_WAITING];
-		count += financial_history[i][HALT_TOO_SLOW];
+		count += get_finance_history(i, HALT_HAPPY);
+		count += get_finance_history(i, HALT_UNHAPPY);
+		count += get_finance_history(i, HALT_TOO_WAITING);
+		count += get_finance_history(i, HALT_TOO_SLOW);
 		if (demand_check) {
-			count += financial_history[i][HALT_NOROUTE];
+			count += get_finance_history(i, HALT_NOROUTE);
 		}
 		if (count > 0) {
 			return true;
@@ -6655,9 +6794,9 @@ bool haltestelle_t::has_mail_user(const uint8 months, bool demand_check) const {
 		if (i >= MAX_MONTHS) {
 			break;
 		}
-		count += financial_history[i][HALT_MAIL_DELIVERED];
+		count += get_finance_history(i, HALT_MAIL_DELIVERED);
 		if (demand_check) {
-			count += financial_history[i][HALT_MAIL_NOROUTE];
+			count += get_finance_history(i, HALT_MAIL_NOROUTE);
 		}
 		if (count > 0) {
 			return true;
@@ -6669,7 +6808,7 @@ bool haltestelle_t::has_mail_user(const uint8 months, bool demand_check) const {
 bool haltestelle_t::is_using() const {
 	sint64 count = 0;
 	for (uint8 i = 0; i < 3; i++) {
-		count += financial_history[i][HALT_CONVOIS_ARRIVED];
+		count += get_finance_history(i, HALT_CONVOIS_ARRIVED);
 		if (count > 0) {
 			return true;
 		}
@@ -34,6 +34,7 @@
 #include "tpl/fixed_list_tpl.h"
 #include "tpl/binary_heap_tpl.h"
 #include "tpl/minivec_tpl.h"
+#include "tpl/ring_history_tpl.h"
 
 #define MAX_HALT_COST				13 // Total number of cost items
 #define MAX_MONTHS					12 // Max history
@@ -118,6 +119,14 @@ private:
 	/// List of all halts in the game.
 	static vector_tpl<halthandle_t> alle_haltestellen;
 
+	/**
+	 * Next halt in alle_haltestellen for the monthly upkeep of the waiting
+	 * times, which is spread over the steps after the month change.
+	 * MONTH_STEP_DONE if nothing is pending.
+	 */
+	static uint32 month_step_index;
+	enum { MONTH_STEP_DONE = 0xFFFFFFFFu };
+
 	/**
 	 * finds a stop by its name
 	 */
@@ -127,7 +136,7 @@ private:
 	 * Finds a stop by coordinate.
 	 * only used during loading.
 	 */
-	static inthashtable_tpl<sint32,halthandle_t, N_BAGS_LARGE> *all_koords;
+	static flat_inthashtable_tpl<sint32,halthandle_t> *all_koords;
 
 	/**
 	 * A list of lines and freight categories that have already been loaded with all available freight at the halt.
@@ -136,9 +145,12 @@ private:
 	static vector_tpl<lines_loaded_t> lines_loaded;
 
 	/*
-	 * struct holds new financial history for line
+	 * struct holds new financial history for line,
+	 * indexed by history_epoch, so a new month costs nothing per halt
 	 */
-	sint64 financial_history[MAX_MONTHS][MAX_HALT_COST];
+	ring_history_tpl<sint64, MAX_MONTHS, MAX_HALT_COST, uint32> financial_history;
+
+	static uint32 history_epoch;
 
 	/**
 	 * initialize the financial history
@@ -272,6 +284,29 @@ public:
 	 */
 	static void destroy_all();
 
+	/**
+	 * Does the monthly upkeep of the waiting times and nearby halts for the next
+	 * chunk of halts, after new_month() was called for all of them.
+	 * @param finish process all remaining halts at once
+	 */
+	static void step_month(bool finish);
+
+	/// starts a new month for the financial history of all halts (without touching them)
+	static void new_history_month() { history_epoch++; }
+
+	/// starts the upkeep of step_month() with the first halt
+	static void start_month_step() { month_step_index = 0; }
+
+	/// saves the progress of step_month()
+	static void rdwr_month_step(loadsave_t *file);
+
+	/**
+	 * Times inserting and looking up the keys of all connexion tables of all
+	 * halts in the bag based hashtable_tpl and in the flat_hashtable_tpl
+	 * used now and appends the results to @p buf.
+	 */
+	static void benchmark_connexion_tables(cbuffer_t &buf);
+
 	uint32 get_number_of_halts_within_walking_distance() const;
 
 	halthandle_t get_halt_within_walking_distance(uint32 index) const { return halts_within_walking_distance[index]; }
@@ -319,7 +354,7 @@ public:
 
 	bool is_within_walking_distance_of(halthandle_t halt) const;
 
-	typedef quickstone_hashtable_tpl<haltestelle_t, connexion*, N_BAGS_MEDIUM> connexions_map;
+	typedef flat_quickstone_hashtable_tpl<haltestelle_t, connexion*> connexions_map;
 
 	struct waiting_time_set
 	{
@@ -327,7 +362,7 @@ public:
 		uint8 month;
 	};
 
-	typedef inthashtable_tpl<uint32, waiting_time_set, N_BAGS_SMALL> waiting_time_map;
+	typedef flat_inthashtable_tpl<uint32, waiting_time_set> waiting_time_map;
 
 	void add_control_tower() { control_towers ++; }
 	void remove_control_tower() { if(control_towers > 0) control_towers --; }
@@ -596,6 +631,12 @@ public:
 	 */
 	void new_month();
 
+	/**
+	 * Monthly upkeep which need not happen at the month change,
+	 * called by step_month()
+	 */
+	void age_waiting_times();
+
 	// @author: jamespetts, although much is borrowed from suche_route
 	// Returns the journey time of the best possible route from this halt. Time == UINT32_MAX_VALUE when there is no route.
 	uint32 find_route(ware_t &ware, const uint32 journey_time = UINT32_MAX_VALUE) const;
@@ -667,13 +708,13 @@ public:
 	// Waiting so long at the station. added 01/2019(EX14.3)
 	void add_pax_too_waiting(int n);
 
-	int get_pax_happy()    const { return (int)financial_history[0][HALT_HAPPY]; }
-	int get_pax_no_route() const { return (int)financial_history[0][HALT_NOROUTE]; }
-	int get_pax_unhappy()  const { return (int)financial_history[0][HALT_UNHAPPY]; }
-	int get_pax_too_slow()  const { return (int)financial_history[0][HALT_TOO_SLOW]; }
-	int get_pax_too_waiting() const { return (int)financial_history[0][HALT_TOO_WAITING]; }
-	int get_mail_delivered()  const { return (int)financial_history[0][HALT_MAIL_DELIVERED]; }
-	int get_mail_no_route()   const { return (int)financial_history[0][HALT_MAIL_NOROUTE]; }
+	int get_pax_happy()    const { return (int)get_finance_history(0, HALT_HAPPY); }
+	int get_pax_no_route() const { return (int)get_finance_history(0, HALT_NOROUTE); }
+	int get_pax_unhappy()  const { return (int)get_finance_history(0, HALT_UNHAPPY); }
+	int get_pax_too_slow()  const { return (int)get_finance_history(0, HALT_TOO_SLOW); }
+	int get_pax_too_waiting() const { return (int)get_finance_history(0, HALT_TOO_WAITING); }
+	int get_mail_delivered()  const { return (int)get_finance_history(0, HALT_MAIL_DELIVERED); }
+	int get_mail_no_route()   const { return (int)get_finance_history(0, HALT_MAIL_NOROUTE); }
 
 	/**
 	 * Add tile to list of station tiles.
@@ -702,6 +743,9 @@ public:
 
 	/// @returns total amount of the good waiting at this halt.
 	uint32 get_ware_summe(const goods_desc_t *warentyp) const;
+
+	/// @returns hash over all waiting cargo (amount, type and destinations) for desync detection
+	uint32 get_cargo_hash() const;
 	uint32 get_ware_summe(const goods_desc_t *warentyp, uint8 wealth_class, bool chk_only_commuter = false) const;
 	uint32 get_ware_summe(const goods_desc_t *warentyp, linehandle_t line, uint8 wealth_class=255) const;
 
@@ -872,14 +916,14 @@ public:
 	void book(sint64 amount, int cost_type);
 
 	/**
-	 * return a pointer to the financial history
+	 * copies the financial history into @p dest as [MAX_MONTHS][MAX_HALT_COST] array (for the charts)
 	 */
-	sint64* get_finance_history() { return *financial_history; }
+	void get_finance_history(sint64 *dest) const;
 
 	/**
 	 * return a specified element from the financial history
 	 */
-	sint64 get_finance_history(int month, int cost_type) const { return financial_history[month][cost_type]; }
+	sint64 get_finance_history(int month, int cost_type) const { return financial_history.get( month, cost_type, history_epoch ); }
 
 	/* marks a coverage area */
 	void mark_unmark_coverage(const bool mark, const bool factories = false) const;
@@ -903,11 +947,11 @@ public:
 	sint64 get_potential_passenger_number(uint8 month) const
 	{
 		sint64 sum=0;
-		sum += financial_history[month][HALT_HAPPY];
-		sum += financial_history[month][HALT_UNHAPPY];
-		sum += financial_history[month][HALT_NOROUTE];
-		sum += financial_history[month][HALT_TOO_SLOW];
-		sum += financial_history[month][HALT_TOO_WAITING];
+		sum += get_finance_history(month, HALT_HAPPY);
+		sum += get_finance_history(month, HALT_UNHAPPY);
+		sum += get_finance_history(month, HALT_NOROUTE);
+		sum += get_finance_history(month, HALT_TOO_SLOW);
+		sum += get_finance_history(month, HALT_TOO_WAITING);
 		return sum;
 	}
 
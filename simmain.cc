@@ -36,6 +36,7 @@
 #include "sys/simsys.h"
 #include "display/simgraph.h"
 #include "simevent.h"
+#include "simbenchmark.h"
 
 #include "simversion.h"
 
@@ -65,6 +66,7 @@
 #include "dataobj/settings.h"
 #include "dataobj/translator.h"
 #include "network/pakset_info.h"
+#include "network/command_journal.h"
 
 #include "descriptor/reader/obj_reader.h"
 #include "descriptor/sound_desc.h"
@@ -75,6 +77,7 @@
 
 #include "utils/cbuffer_t.h"
 #include "utils/simrandom.h"
+#include "utils/step_profiler.h"
 #include "unicode.h"
 
 #include "bauer/vehikelbauer.h"
@@ -367,6 +370,27 @@ void print_help()
 		" -server_name NAME   Name of server for announcements\n"
 		" -server_admin_pw PW password for server administration\n"
 		" -heavy NUM          enables heavy-mode debugging for network games. VERY SLOW!\n"
+		" -journal NAME       records all world commands of a network game to save/NAME.jnl,\n"
+		"                     the game at the start of the recording is saved to save/NAME.sve\n"
+		" -replay NAME        loads save/NAME.sve, replays save/NAME.jnl without display\n"
+		"                     as fast as possible, prints the step timings and quits;\n"
+		"                     fails if the game diverges from the recorded checklists\n"
+		" -blitbench [ROUNDS] draws all images of the pakset with every image drawing\n"
+		"                     routine supported by this cpu, prints the times and quits\n"
+		" -stepbench [STEPS]  runs STEPS steps (default 100) of the game without display,\n"
+		"                     prints the step times, allocation statistics and hashtable\n"
+		"                     throughput on the connexion tables and quits\n"
+		" -benchmark NAME     creates the fixed world NAME (small, medium or large) or\n"
+		"                     loads save/NAME.sve, runs it without display and writes\n"
+		"                     step phase times, peak memory, allocations and state\n"
+		"                     hashes as JSON to stdout, then quits\n"
+		" -benchmark_steps N  number of measured steps of -benchmark (default 100)\n"
+		" -benchmark_json FILE\n"
+		"                     writes the result of -benchmark to FILE instead\n"
+		" -profile_steps FILE writes the time of every phase of every step to FILE,\n"
+		"                     as Chrome trace if FILE ends with .json, else as csv\n"
+		" -statehash_log      writes per-object state hashes to desync/statehash-*.txt\n"
+		"                     compare two runs with scripts/statehash-diff.sh\n"
 		" -set_workdir WD     Use WD as directory containing all data.\n"
 		" -singleuser         Save everything in data directory (portable version)\n"
 #ifdef DEBUG
@@ -743,6 +767,7 @@ int simu_main(int argc, char** argv)
 		int heavy = atoi(args.gimme_arg("-heavy", 1));
 		env_t::network_heavy_mode = clamp(heavy, 0, 2);
 	}
+	env_t::subsystem_hash_log = args.has_arg("-statehash_log");
 
 #ifdef DEBUG
 	DBG_MESSAGE("simu_main()", "Version:    " VERSION_NUMBER EXTENDED_VERSION "  Date: " VERSION_DATE);
@@ -884,7 +909,8 @@ int simu_main(int argc, char** argv)
 		simuconf.close();
 	}
 
-	// prepare skins first
+	// prepare skins first (not needed without display)
+#if COLOUR_DEPTH != 0
 	bool themes_ok = false;
 	if(  const char *themestr = args.gimme_arg("-theme", 1)  ) {
 		dr_chdir( env_t::user_dir );
@@ -908,7 +934,6 @@ int simu_main(int argc, char** argv)
 		}
 	}
 	// specified themes not found => try default themes
-#if COLOUR_DEPTH != 0
 	if(  !themes_ok  ) {
 		dr_chdir( env_t::data_dir );
 		dr_chdir( "themes" );
@@ -1089,7 +1114,8 @@ int simu_main(int argc, char** argv)
 #endif
 
 	// just check before loading objects
-	if(  !args.has_arg("-nosound")  &&  dr_init_sound()  ) {
+	// (without display there is nobody to listen, so sounds stay unloaded)
+	if(  COLOUR_DEPTH != 0  &&  !args.has_arg("-nosound")  &&  dr_init_sound()  ) {
 		dbg->message("simu_main()","Reading compatibility sound data ...");
 		sound_desc_t::init();
 	}
@@ -1256,7 +1282,16 @@ int simu_main(int argc, char** argv)
 		env_t::server_runs_background_tasks_when_paused = true;
 	}
 
-	if(  args.has_arg("-load")  ) {
+	const char *replay_name = args.gimme_arg("-replay", 1);
+	if(  replay_name  ) {
+		cbuffer_t buf;
+		dr_chdir( env_t::user_dir );
+		buf.printf( SAVE_PATH_X "%s.sve", replay_name );
+		dbg->message("simu_main()", "Loading savegame \"%s\" for replay", buf.get_str() );
+		loadgame = buf;
+		new_world = false;
+	}
+	else if(  args.has_arg("-load")  ) {
 		cbuffer_t buf;
 		dr_chdir( env_t::user_dir );
 		/**
@@ -1362,7 +1397,7 @@ int simu_main(int argc, char** argv)
 	dr_chdir( env_t::user_dir );
 
 	// init midi before loading sounds
-	if(  dr_init_midi()  ) {
+	if(  COLOUR_DEPTH != 0  &&  dr_init_midi()  ) {
 		dbg->message("simu_main()","Reading midi data ...");
 		char pak_dir[PATH_MAX];
 		sprintf( pak_dir, "%s%s", env_t::data_dir, env_t::objfilename.c_str() );
@@ -1555,6 +1590,44 @@ int simu_main(int argc, char** argv)
 	}
 #endif
 
+	if(  const char *profile_name = args.gimme_arg("-profile_steps", 1)  ) {
+		step_profiler_t::open_export( profile_name );
+	}
+
+	// a failed replay or benchmark must be noticed by the calling script
+	int exit_code = EXIT_SUCCESS;
+	if(  replay_name  ) {
+		cbuffer_t buf;
+		buf.printf( SAVE_PATH_X "%s.jnl", replay_name );
+		if(  !welt->replay_journal( buf )  ) {
+			dbg->error( "simu_main()", "Replay of command journal %s failed", buf.get_str() );
+			exit_code = EXIT_FAILURE;
+		}
+		env_t::quit_simutrans = true;
+	}
+
+	if(  args.has_arg("-blitbench")  ) {
+		const char *rounds = args.gimme_arg("-blitbench", 1);
+		display_benchmark_blitters( rounds  &&  atoi(rounds) > 0 ? atoi(rounds) : 10 );
+		env_t::quit_simutrans = true;
+	}
+
+	if(  args.has_arg("-stepbench")  ) {
+		const char *steps = args.gimme_arg("-stepbench", 1);
+		welt->benchmark_steps( steps  &&  atoi(steps) > 0 ? atoi(steps) : 100 );
+		env_t::quit_simutrans = true;
+	}
+
+	if(  const char *benchmark_name = args.gimme_arg("-benchmark", 1)  ) {
+		const char *steps = args.gimme_arg("-benchmark_steps", 1);
+		if(  !benchmark_t::run( welt, benchmark_name, steps  &&  atoi(steps) > 0 ? atoi(steps) : 100, args.gimme_arg("-benchmark_json", 1) )  ) {
+			exit_code = EXIT_FAILURE;
+		}
+		env_t::quit_simutrans = true;
+	}
+
+	const char *journal_name = args.gimme_arg("-journal", 1);
+
 	welt->reset_timer();
 	if(  !env_t::networkmode  &&  !env_t::server  &&  new_world  ) {
 #ifdef display_in_main
@@ -1620,9 +1693,28 @@ int simu_main(int argc, char** argv)
 		dbg->message("simu_main()", "Running world, pause=%i, fast forward=%i ... ", welt->is_paused(), welt->is_fast_forward() );
 		loadgame = ""; // only first time
 
+		if(  journal_name  &&  env_t::networkmode  ) {
+			// the journal is replayed against the game as it is now
+			cbuffer_t buf;
+			buf.printf( SAVE_PATH_X "%s.sve", journal_name );
+			welt->save( buf, false, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR, true );
+			buf.clear();
+			buf.printf( SAVE_PATH_X "%s.jnl", journal_name );
+			command_journal_t::recorder = new command_journal_t();
+			command_journal_t::recorder->open_record( buf );
+			// only the first game is recorded
+			journal_name = NULL;
+		}
+
 		// run the loop
 		welt->interactive(quit_month);
 
+		if(  command_journal_t::recorder  ) {
+			command_journal_t::recorder->finish( welt->get_sync_steps() );
+			delete command_journal_t::recorder;
+			command_journal_t::recorder = NULL;
+		}
+
 		new_world = true;
 		welt->get_message()->get_message_flags(&env_t::message_flags[0], &env_t::message_flags[1], &env_t::message_flags[2], &env_t::message_flags[3]);
 		welt->set_fast_forward(false);
@@ -1631,6 +1723,7 @@ int simu_main(int argc, char** argv)
 
 		dbg->message("simu_main()", "World finished ..." );
 	}
+	step_profiler_t::close_export();
 
 	intr_disable();
 
@@ -1671,5 +1764,5 @@ int simu_main(int argc, char** argv)
 	freelist_t::free_all_nodes();
 #endif
 
-	return EXIT_SUCCESS;
+	return exit_code;
 }
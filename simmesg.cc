@@ -180,6 +180,8 @@ DBG_MESSAGE("message_t::add_msg()","%40s (at %i,%i)", text, pos.x, pos.y );
 
 	// insert at the top
 	list.insert(n);
+
+#if COLOUR_DEPTH != 0
 	char* p = list.front()->msg;
 
 	// if we are not current player, do not open windows
@@ -207,6 +209,7 @@ DBG_MESSAGE("message_t::add_msg()","%40s (at %i,%i)", text, pos.x, pos.y );
 	if(  old_top    ) {
 		top_win( old_top, true );
 	}
+#endif
 }
 
 
@@ -3220,6 +3220,8 @@ void tool_build_way_t::set_mode_str(char* str, overtaking_mode_t overtaking_mode
 void tool_build_way_t::mark_tiles(  player_t *player, const koord3d &start, const koord3d &end )
 {
 	way_builder_t bauigel(player);
+	// while dragging the end, reuse the search from the same start
+	bauigel.set_reuse_search(true);
 	bool route_reversed = calc_route( bauigel, start, end );
 
 	uint8 offset = (desc->get_styp() == type_elevated  &&  desc->get_wtyp() != air_wt) ? welt->get_settings().get_way_height_clearance() : 0;
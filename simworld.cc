@@ -80,6 +80,7 @@
 #include "network/network_file_transfer.h"
 #include "network/network_socket_list.h"
 #include "network/network_cmd_ingame.h"
+#include "network/command_journal.h"
 #include "dataobj/height_map_loader.h"
 #include "dataobj/ribi.h"
 #include "dataobj/translator.h"
@@ -89,10 +90,12 @@
 #include "dataobj/environment.h"
 #include "dataobj/powernet.h"
 #include "dataobj/marker.h"
+#include "dataobj/freelist.h"
 
 #include "utils/cbuffer_t.h"
 #include "utils/simrandom.h"
 #include "utils/simstring.h"
+#include "utils/step_profiler.h"
 
 #include "network/memory_rw.h"
 
@@ -487,6 +490,8 @@ void karte_t::destroy()
 	destroying = true;
 	DBG_MESSAGE("karte_t::destroy()", "destroying world");
 
+	way_builder_t::clear_last_search();
+
 #ifdef MULTI_THREAD
 	suspend_private_car_threads();
 	destroy_threads();
@@ -727,6 +732,8 @@ void karte_t::init_tiles()
 	last_frame_idx = 0;
 	pending_season_change = 0;
 	pending_snowline_change = 0;
+	way_month_tile = WAY_MONTH_DONE;
+	factory_step_delta_t = 0;
 
 	// init global history
 	for (int year=0; year<MAX_WORLD_HISTORY_YEARS; year++) {
@@ -2668,6 +2675,9 @@ void karte_t::init_height_to_climate()
 
 void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 {
+	// the pending way month is tied to the tile order
+	step_way_month(true);
+
 	sint16 new_size_x = sets->get_size_x();
 	sint16 new_size_y = sets->get_size_y();
 	//const sint32 map_size = max (new_size_x, new_size_y);
@@ -3077,6 +3087,7 @@ karte_t::karte_t() :
 
 	zeiger = 0;
 	plan = 0;
+	way_month_tile = WAY_MONTH_DONE;
 
 	grid_hgts = 0;
 	water_hgts = 0;
@@ -3801,6 +3812,9 @@ DBG_MESSAGE( "karte_t::rotate90()", "called" );
 	// Wait for any threaded work
 	await_all_threads();
 
+	// the pending way month is tied to the tile order
+	step_way_month(true);
+
 	// assume we can save this rotation
 	nosave_warning = nosave = false;
 
@@ -4246,6 +4260,7 @@ void karte_t::sync_step(uint32 delta_t, bool do_sync_step, bool display )
 	set_random_mode( SYNC_STEP_RANDOM );
 	if(do_sync_step) {
 		// Only omitted when called to display a new frame during fast forward
+		step_profiler_t::scope_t profile(step_profiler_t::SYNC_STEP);
 
 		// just for progress
 		if(  delta_t > 10000  ) {
@@ -4325,7 +4340,10 @@ void karte_t::sync_step(uint32 delta_t, bool do_sync_step, bool display )
 		}
 
 		// display new frame with water animation
-		intr_refresh_display( false );
+		{
+			step_profiler_t::scope_t profile(step_profiler_t::DISPLAY);
+			intr_refresh_display( false );
+		}
 		update_frame_sleep_time();
 	}
 
@@ -4499,10 +4517,11 @@ void karte_t::new_month()
 	DBG_MESSAGE("karte_t::new_month()","Month (%d/%d) has started", (last_month%12)+1, last_month/12 );
 
 	// this should be done before a map update, since the map may want an update of the way usage
+	// the way statistics are indexed by the month epoch, the wear is applied over the next steps
 //	DBG_MESSAGE("karte_t::new_month()","ways");
-	FOR(vector_tpl<weg_t*>, const w, weg_t::get_alle_wege()) {
-		w->new_month();
-	}
+	step_way_month(true);
+	weg_t::new_statistics_month();
+	way_month_tile = 0;
 
 	// Update the maximum vehicle speed records to calibrate when passengers should not burden the journey time database.
 	calc_max_vehicle_speeds();
@@ -4654,10 +4673,14 @@ void karte_t::new_month()
 	INT_CHECK("simworld 3130");
 
 //	DBG_MESSAGE("karte_t::new_month()","halts");
+	// the waiting times are aged over the next steps
+	haltestelle_t::step_month(true);
+	haltestelle_t::new_history_month();
 	FOR(vector_tpl<halthandle_t>, const s, haltestelle_t::get_alle_haltestellen()) {
 		s->new_month();
 		INT_CHECK("simworld 1877");
 	}
+	haltestelle_t::start_month_step();
 
 	INT_CHECK("simworld 2522");
 	FOR(slist_tpl<depot_t *>, const& iter, depot_t::get_depot_list())
@@ -4967,11 +4990,123 @@ void karte_t::pause_step()
 #endif
 }
 
+void karte_t::step_way_month(bool finish)
+{
+	const uint32 tile_count = cached_grid_size.x * cached_grid_size.y;
+	if(  way_month_tile >= tile_count  ) {
+		way_month_tile = WAY_MONTH_DONE;
+		return;
+	}
+
+	const uint32 end_count = finish ? tile_count : min( tile_count, way_month_tile + max( 16384u, tile_count / 64 ) );
+	while(  way_month_tile < end_count  ) {
+		const planquadrat_t &pl = plan[way_month_tile];
+		for(  uint i = 0;  i < pl.get_boden_count();  i++  ) {
+			grund_t *gr = pl.get_boden_bei(i);
+			for(  int j = 0;  j < 2;  j++  ) {
+				if(  weg_t *w = gr->get_weg_nr(j)  ) {
+					w->new_month();
+				}
+			}
+		}
+		way_month_tile++;
+	}
+
+	if(  way_month_tile >= tile_count  ) {
+		way_month_tile = WAY_MONTH_DONE;
+	}
+}
+
+
+void karte_t::step_players_plan_loop(sint16, sint16, sint16 y_min, sint16 y_max)
+{
+	for(  int i=0;  i<MAX_PLAYER_COUNT;  i++  ) {
+		if(  players[i] != NULL  ) {
+			players[i]->plan(y_min, y_max);
+		}
+	}
+}
+
+
+void karte_t::step_players()
+{
+	// Planning only reads the world and does not use simrand, so the AIs
+	// act the same with and without threads.
+	bool planning = false;
+	for(  int i=0;  i<MAX_PLAYER_COUNT;  i++  ) {
+		if(  players[i] != NULL  &&  players[i]->begin_planning()  ) {
+			planning = true;
+		}
+	}
+	if(  planning  ) {
+		world_xy_loop(&karte_t::step_players_plan_loop, 0);
+	}
+
+	for(  int i=0;  i<MAX_PLAYER_COUNT;  i++  ) {
+		if(  players[i] != NULL  ) {
+			players[i]->step();
+		}
+	}
+}
+
+
+// the threads of world_xy_loop() get the y range of their rows, which is
+// mapped onto the same share of fab_list, so no thread scans the whole list
+static inline uint32 fab_list_index_of_row(uint32 fab_count, sint16 y, sint16 size_y)
+{
+	return (uint32)(((uint64)fab_count * (uint32)y) / (uint32)size_y);
+}
+
+
+void karte_t::step_factories_production_loop(sint16, sint16, sint16 y_min, sint16 y_max)
+{
+	const uint32 end = fab_list_index_of_row( fab_list.get_count(), y_max, cached_grid_size.y );
+	for(  uint32 i = fab_list_index_of_row( fab_list.get_count(), y_min, cached_grid_size.y );  i < end;  i++  ) {
+		fab_list[i]->step_production(factory_step_delta_t);
+	}
+}
+
+
+void karte_t::step_factories_plan_loop(sint16, sint16, sint16 y_min, sint16 y_max)
+{
+	const uint32 end = fab_list_index_of_row( fab_list.get_count(), y_max, cached_grid_size.y );
+	for(  uint32 i = fab_list_index_of_row( fab_list.get_count(), y_min, cached_grid_size.y );  i < end;  i++  ) {
+		fab_list[i]->plan_distribution();
+	}
+}
+
+
+void karte_t::step_factories(uint32 delta_t)
+{
+	if(  settings.using_fab_contracts()  ) {
+		// contracts deliver while stepping, so one after another
+		FOR(vector_tpl<fabrik_t*>, const f, fab_list) {
+			f->step(delta_t);
+		}
+		return;
+	}
+
+	// Each factory only changes itself in these two loops, and the second
+	// reads the stock of the consumers, hence all must have produced before.
+	// The threads take equal shares of fab_list.
+	// The same stages are used without threads, to get the same results.
+	factory_step_delta_t = delta_t;
+	world_xy_loop(&karte_t::step_factories_production_loop, 0);
+	world_xy_loop(&karte_t::step_factories_plan_loop, 0);
+
+	// changes halts and consumers, so serial and in a fixed order
+	FOR(vector_tpl<fabrik_t*>, const f, fab_list) {
+		f->distribute();
+	}
+}
+
+
 void karte_t::step()
 {
 	rands[8] = get_random_seed();
 	DBG_DEBUG4("karte_t::step", "start step");
 	uint32 time = dr_time();
+	const uint64 profile_start = dr_time_us();
 
 	// calculate delta_t before handling overflow in ticks
 	const sint32 delta_t = (sint32)(ticks-last_step_ticks);
@@ -5061,6 +5196,7 @@ void karte_t::step()
 	const bool check_city_routes = true;
 	if (check_city_routes)
 	{
+		step_profiler_t::scope_t profile(step_profiler_t::PRIVATE_CAR_ROUTES);
 		const sint32 parallel_operations = get_parallel_operations();
 
 		if (cities_awaiting_private_car_route_check.empty() && cities_to_process <= 0)
@@ -5124,43 +5260,56 @@ void karte_t::step()
 		}
 	}
 
+	// monthly wear of the ways and upkeep of the halts
+	step_way_month(false);
+	haltestelle_t::step_month(false);
+
 	rands[11] = get_random_seed();
 
 	// to make sure the tick counter will be updated
 	INT_CHECK("karte_t::step 1");
 
+	{
+		step_profiler_t::scope_t profile(step_profiler_t::PATH_EXPLORER);
 #ifdef MULTI_THREAD_PATH_EXPLORER
-	// Stop the path explorer before we use its results.
-	await_path_explorer();
+		// Stop the path explorer before we use its results.
+		await_path_explorer();
 #else
-	// Knightly : calling global path explorer
-	path_explorer_t::step();
+		// Knightly : calling global path explorer
+		path_explorer_t::step();
 #endif
+	}
 	rands[12] = get_random_seed();
 
 	INT_CHECK("karte_t::step 2");
 
+	{
+		step_profiler_t::scope_t profile(step_profiler_t::THREADED_STEP);
 #ifdef MULTI_THREAD_CONVOYS
-	// Finish the threaded part of the convoys' steps: this is mainly route searches. Block reservation, etc., is in the single threaded part.
-	await_convoy_threads();
+		// Finish the threaded part of the convoys' steps: this is mainly route searches. Block reservation, etc., is in the single threaded part.
+		await_convoy_threads();
 #else
-	for (uint32 i = convoi_array.get_count(); i-- != 0;)
-	{
-		convoihandle_t cnv = convoi_array[i];
-		cnv->threaded_step();
-	}
+		for (uint32 i = convoi_array.get_count(); i-- != 0;)
+		{
+			convoihandle_t cnv = convoi_array[i];
+			cnv->threaded_step();
+		}
 #endif
+	}
 
 	rands[13] = get_random_seed();
 
 	// The more computationally intensive parts of this have been extracted and made multi-threaded.
 	DBG_DEBUG4("karte_t::step 4", "step %d convois", convoi_array.get_count());
 	// since convois will be deleted during stepping, we need to step backwards
-	for (uint32 i = convoi_array.get_count(); i-- != 0;) {
-		convoihandle_t cnv = convoi_array[i];
-		cnv->step();
-		if((i&7)==0) {
-			INT_CHECK("karte_t::step 3");
+	{
+		step_profiler_t::scope_t profile(step_profiler_t::CONVOYS);
+		for (uint32 i = convoi_array.get_count(); i-- != 0;) {
+			convoihandle_t cnv = convoi_array[i];
+			cnv->step();
+			if((i&7)==0) {
+				INT_CHECK("karte_t::step 3");
+			}
 		}
 	}
 
@@ -5180,9 +5329,12 @@ void karte_t::step()
 #ifndef CONCURRENT_ROUTE_PROCESSING
 	uint32 step_cities_count = 0;
 #endif
-	FOR(weighted_vector_tpl<stadt_t*>, const i, cities)
 	{
-		i->step(delta_t);
+		step_profiler_t::scope_t profile(step_profiler_t::CITIES);
+		FOR(weighted_vector_tpl<stadt_t*>, const i, cities)
+		{
+			i->step(delta_t);
+		}
 	}
 
 	rands[15] = get_random_seed();
@@ -5193,6 +5345,7 @@ void karte_t::step()
 	// The placement of this method call must be before any code that in any way relies on the private car routes between cities, most especially the mail and passenger generation (step_passengers_and_mail(delta_t)).
 	if (check_city_routes)
 	{
+		step_profiler_t::scope_t profile(step_profiler_t::PRIVATE_CAR_ROUTES);
 		await_private_car_threads();
 	}
 #endif
@@ -5252,17 +5405,24 @@ void karte_t::step()
 			debug_sums[6] += transferring_cargoes[i].get_count();
 		}
 
-		start_passengers_and_mail_threads();
+		{
+			step_profiler_t::scope_t profile(step_profiler_t::PASSENGERS);
+			start_passengers_and_mail_threads();
+		}
 
 #ifdef FORBID_MULTI_THREAD_PASSENGER_GENERATION_IN_NETWORK_MODE
 	}
 	else
 	{
+		step_profiler_t::scope_t profile(step_profiler_t::PASSENGERS);
 		step_passengers_and_mail(delta_t);
 	}
 #endif
 #else
-	step_passengers_and_mail(delta_t);
+	{
+		step_profiler_t::scope_t profile(step_profiler_t::PASSENGERS);
+		step_passengers_and_mail(delta_t);
+	}
 #endif
 	DBG_DEBUG4("karte_t::step", "step generate passengers and mail");
 
@@ -5289,8 +5449,11 @@ void karte_t::step()
 
 	INT_CHECK("karte_t::step 4");
 
-	// This does nothing if the threading is disabled.
-	await_passengers_and_mail_threads();
+	{
+		// This does nothing if the threading is disabled.
+		step_profiler_t::scope_t profile(step_profiler_t::PASSENGERS);
+		await_passengers_and_mail_threads();
+	}
 
 	rands[19] = get_random_seed();
 
@@ -5361,8 +5524,9 @@ void karte_t::step()
 	INT_CHECK("karte_t::step 5");
 
 	DBG_DEBUG4("karte_t::step", "step factories");
-	FOR(vector_tpl<fabrik_t*>, const f, fab_list) {
-		f->step(delta_t);
+	{
+		step_profiler_t::scope_t profile(step_profiler_t::FACTORIES);
+		step_factories(delta_t);
 	}
 	rands[20] = get_random_seed();
 
@@ -5381,18 +5545,17 @@ void karte_t::step()
 	DBG_DEBUG4("karte_t::step", "step players");
 	// then step all players
 	// This is not computationally intensive (except possibly occasionally when liquidating a company)
-	for(  int i=0;  i<MAX_PLAYER_COUNT;  i++  ) {
-		if(  players[i] != NULL  ) {
-			players[i]->step();
-		}
-	}
+	step_players();
 	rands[22] = get_random_seed();
 
 	INT_CHECK("karte_t::step 7");
 
 	// This is not computationally intensive
 	DBG_DEBUG4("karte_t::step", "step halts");
-	haltestelle_t::step_all();
+	{
+		step_profiler_t::scope_t profile(step_profiler_t::HALTS);
+		haltestelle_t::step_all();
+	}
 	rands[23] = get_random_seed();
 
 	// Re-check paths if the time has come.
@@ -5416,9 +5579,12 @@ void karte_t::step()
 	rands[25] = get_random_seed();
 
 #ifdef MULTI_THREAD_PATH_EXPLORER
-	// Start the path explorer ready for the next step. This can be very
-	// computationally intensive, but intermittently so.
-	start_path_explorer();
+	{
+		// Start the path explorer ready for the next step. This can be very
+		// computationally intensive, but intermittently so.
+		step_profiler_t::scope_t profile(step_profiler_t::PATH_EXPLORER);
+		start_path_explorer();
+	}
 #endif
 
 #ifdef MULTI_THREAD_CONVOYS
@@ -5480,6 +5646,9 @@ void karte_t::step()
 
 	DBG_DEBUG4("karte_t::step", "end");
 	rands[26] = get_random_seed();
+
+	step_profiler_t::add( step_profiler_t::STEP, profile_start, dr_time_us() - profile_start );
+	step_profiler_t::end_step( steps );
 }
 
 void karte_t::refresh_private_car_routes() {
@@ -8442,6 +8611,12 @@ void karte_t::rdwr_gamestate(loadsave_t *file, loadingscreen_t *ls)
 		tree_builder_t::rdwr_tree_ids(file);
 	}
 
+	// progress of the monthly way wear
+	if(  file->is_version_ex_atleast(14, 66)  ) {
+		file->rdwr_long( way_month_tile );
+	}
+	haltestelle_t::rdwr_month_step(file);
+
 	// rdwr cityrules for networkgames
 	if(file->is_version_atleast(102, 3) && (file->get_extended_version() == 0 || file->get_extended_version() >= 9)) {
 		bool do_rdwr = env_t::networkmode;
@@ -9756,6 +9931,22 @@ void karte_t::prepare_tiles(rect_t const &new_area, rect_t const &old_area) {
 			}
 		}
 	}
+
+	// tiles which left the view do not need their draw lists any more
+	rect_t old_visible_area = old_area;
+	old_visible_area.mask(rect_t(koord(0, 0), get_size()));
+	size_t const release_rects_length = old_visible_area.fragment_difference(new_area, prepare_rects, prepare_rects_capacity);
+	for (size_t rect_index = 0 ; rect_index < release_rects_length ; rect_index++) {
+		rect_t const &release_rect = prepare_rects[rect_index];
+		for (sint16 y = release_rect.origin.y ; y < release_rect.origin.y + release_rect.size.y ; y++) {
+			for (sint16 x = release_rect.origin.x ; x < release_rect.origin.x + release_rect.size.x ; x++) {
+				const planquadrat_t &tile = plan[y * cached_grid_size.x + x];
+				for (uint8 i = 0 ; i < tile.get_boden_count() ; i++) {
+					tile.get_boden_bei(i)->free_draw_list();
+				}
+			}
+		}
+	}
 }
 
 void karte_t::update_underground_intern( sint16 x_min, sint16 x_max, sint16 y_min, sint16 y_max )
@@ -10754,6 +10945,12 @@ void karte_t::do_network_world_command(network_world_command_t *nwc)
 
 		if(client_checklist != server_checklist)
 		{
+			const uint8 mismatches = client_checklist.get_subsystem_mismatches(server_checklist);
+			for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+				if(  mismatches & (1 << i)  ) {
+					dbg->warning("karte_t:::do_network_world_command", "sync_step=%u: state of %s diverged", server_sync_step, checklist_t::get_subsystem_name(i));
+				}
+			}
 			network_disconnect();
 			// output warning / throw fatal error depending on heavy mode setting
 			void (log_t::*outfn)(const char*, const char*, ...) = (env_t::network_heavy_mode == 2 ? &log_t::fatal : &log_t::warning);
@@ -10776,6 +10973,15 @@ void karte_t::do_network_world_command(network_world_command_t *nwc)
 				}
 			}
 		}
+		if(  command_journal_t::recorder  ) {
+			if(  nwc->get_id() == NWC_SYNC  ) {
+				// the reload for a joining client changes the game too, the replay reloads at the same sync step
+				command_journal_t::recorder->record_sync(sync_steps);
+			}
+			else {
+				command_journal_t::recorder->record(nwc, sync_steps);
+			}
+		}
 		nwc->do_command(this);
 	}
 }
@@ -10928,7 +11134,9 @@ bool karte_t::interactive(uint32 quit_month)
 		if(  (sint32)next_step_time - (sint32)time <= 0  ) {
 			if(  step_mode&PAUSE_FLAG  ) {
 				// only update display
+				step_profiler_t::set_idle(true);
 				sync_step(0, false, true);
+				step_profiler_t::set_idle(false);
 				if (env_t::server && env_t::server_runs_background_tasks_when_paused && socket_list_t::get_playing_clients() == 0)
 				{
 					pause_step();
@@ -10940,7 +11148,9 @@ bool karte_t::interactive(uint32 quit_month)
 				}
 			}
 			else if (env_t::networkmode && !env_t::server && sync_steps >= sync_steps_barrier) {
+				step_profiler_t::set_idle(true);
 				sync_step(0, false, true);
+				step_profiler_t::set_idle(false);
 				next_step_time = time + fix_ratio_frame_time;
 			}
 			else {
@@ -10978,9 +11188,11 @@ bool karte_t::interactive(uint32 quit_month)
 					switch(env_t::network_heavy_mode) {
 						case 0:
 						default:
-							LCHKLST(sync_steps) = checklist_t(sync_steps, (uint32)steps, network_frame_count, get_random_seed(), halthandle_t::get_next_check(), linehandle_t::get_next_check(), convoihandle_t::get_next_check(),
-								rands, debug_sums
-							);
+							LCHKLST(sync_steps) = calc_checklist( env_t::server ? "server" : "client" );
+							if(  command_journal_t::recorder  &&  (sync_steps % env_t::server_sync_steps_between_checks) == 0  ) {
+								// the replay must arrive at the same checklists
+								command_journal_t::recorder->record_checklist( LCHKLST(sync_steps), sync_steps );
+							}
 							break;
 						case 2:
 							heavy_rotate_saves(env_t::server ? "server" : "client", sync_steps, 10);
@@ -11020,6 +11232,11 @@ bool karte_t::interactive(uint32 quit_month)
 					set_random_mode( STEP_RANDOM );
 					step();
 					clear_random_mode( STEP_RANDOM );
+					if(  env_t::subsystem_hash_log  ) {
+						// local runs log every step, so two runs of the same game can be compared step by step
+						uint32 subsystem_hashes[CHK_SUBSYSTEMS];
+						calc_subsystem_hashes(subsystem_hashes, "local", (uint32)steps);
+					}
 					uint32 cur_time = dr_time();
 					if (next_step_time > cur_time) {
 						// slowly change idel time
@@ -11059,6 +11276,187 @@ bool karte_t::interactive(uint32 quit_month)
 }
 
 
+// prints a table of all used size classes of the freelist
+static void dump_freelist_statistics(cbuffer_t &buf)
+{
+	freelist_t::stats_t stats[freelist_t::STATS_COUNT];
+	freelist_t::get_statistics(stats);
+	buf.printf( "Freelist:\n" );
+	buf.printf( "size      allocs       frees   refills   returns  contended  chunks\n" );
+	for(  int i=0;  i<freelist_t::STATS_COUNT;  i++  ) {
+		const freelist_t::stats_t &s = stats[i];
+		if(  s.allocs | s.frees | s.refills | s.returns  ) {
+			if(  i+1 < freelist_t::STATS_COUNT  ) {
+				buf.printf( "%4d", i*4 );
+			}
+			else {
+				buf.printf( "%4s", "more" );
+			}
+			buf.printf( " %11llu %11llu %9llu %9llu %10llu %7u\n",
+				(unsigned long long)s.allocs, (unsigned long long)s.frees, (unsigned long long)s.refills,
+				(unsigned long long)s.returns, (unsigned long long)s.contended, s.chunks );
+		}
+	}
+}
+
+
+checklist_t karte_t::calc_checklist(const char *log_name)
+{
+	if(  settings.get_subsystem_hash_interval() > 0  &&  (sync_steps % settings.get_subsystem_hash_interval()) == 0  ) {
+		uint32 subsystem_hashes[CHK_SUBSYSTEMS];
+		calc_subsystem_hashes(subsystem_hashes, log_name, sync_steps, (sync_steps / settings.get_subsystem_hash_interval()) % CHK_HASH_SLICES, CHK_HASH_SLICES);
+		return checklist_t(sync_steps, (uint32)steps, network_frame_count, get_random_seed(), halthandle_t::get_next_check(), linehandle_t::get_next_check(), convoihandle_t::get_next_check(),
+			rands, debug_sums, subsystem_hashes
+		);
+	}
+	return checklist_t(sync_steps, (uint32)steps, network_frame_count, get_random_seed(), halthandle_t::get_next_check(), linehandle_t::get_next_check(), convoihandle_t::get_next_check(),
+		rands, debug_sums
+	);
+}
+
+
+bool karte_t::replay_journal(const char *filename)
+{
+	command_journal_t journal;
+	if(  !journal.open_replay(filename)  ) {
+		return false;
+	}
+
+	// step exactly like a network game does
+	step_mode = FIX_RATIO;
+	reset_timer();
+	sync_steps = 0;
+	network_frame_count = 0;
+
+	uint64 sync_step_time = 0, step_time = 0, command_time = 0;
+	uint64 sync_step_max = 0, step_max = 0;
+	uint32 sync_step_count = 0, step_count = 0;
+
+	uint32 cmd_sync_step = 0, cmd_time_ms = 0;
+	network_world_command_t *nwc = NULL;
+	checklist_t recorded_checklist;
+	command_journal_t::record_type_t record = journal.read(cmd_sync_step, cmd_time_ms, nwc, recorded_checklist);
+	uint32 checklist_count = 0;
+	freelist_t::reset_statistics();
+	const uint64 replay_start = dr_time_us();
+
+	while(  !journal.is_broken()  &&  (record != command_journal_t::RECORD_END  ||  sync_steps < journal.get_last_sync_step())  ) {
+		// records are applied in the order they were written: the checklist of a
+		// sync step was taken before the commands executed at this sync step
+		const uint64 t0 = dr_time_us();
+		while(  record != command_journal_t::RECORD_END  &&  cmd_sync_step <= sync_steps  ) {
+			if(  record == command_journal_t::RECORD_COMMAND  ) {
+				nwc->do_command(this);
+				delete nwc;
+			}
+			else if(  record == command_journal_t::RECORD_SYNC  ) {
+				// a client joined: the game was saved and reloaded like nwc_sync_t does on the server
+				const uint32 old_sync_steps = sync_steps;
+				const bool old_restore_UI = env_t::restore_UI;
+				env_t::restore_UI = true;
+				dr_chdir( env_t::user_dir );
+				save( "replay-network.sve", false, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR, false );
+				load( "replay-network.sve" );
+				env_t::restore_UI = old_restore_UI;
+				sync_steps = old_sync_steps;
+				steps = sync_steps / settings.get_frames_per_step();
+				network_frame_count = sync_steps % settings.get_frames_per_step();
+				step_mode = FIX_RATIO;
+			}
+			else if(  record == command_journal_t::RECORD_CHECKLIST  ) {
+				const checklist_t replayed_checklist = calc_checklist( "replay" );
+				if(  replayed_checklist != recorded_checklist  ) {
+					cbuffer_t buf;
+					recorded_checklist.print( buf, "recorded" );
+					buf.append( " " );
+					replayed_checklist.print( buf, "replayed" );
+					dbg->error( "karte_t::replay_journal", "Replay diverged from the recorded game at sync_step %u: %s", sync_steps, buf.get_str() );
+					return false;
+				}
+				checklist_count ++;
+			}
+			record = journal.read(cmd_sync_step, cmd_time_ms, nwc, recorded_checklist);
+		}
+
+		const uint64 t1 = dr_time_us();
+		sync_step( (fix_ratio_frame_time*time_multiplier)/16, true, false );
+		const uint64 t2 = dr_time_us();
+		command_time += t1 - t0;
+		sync_step_time += t2 - t1;
+		sync_step_max = max( sync_step_max, t2 - t1 );
+		sync_step_count ++;
+
+		if(  ++network_frame_count == settings.get_frames_per_step()  ) {
+			set_random_mode( STEP_RANDOM );
+			step();
+			clear_random_mode( STEP_RANDOM );
+			network_frame_count = 0;
+			const uint64 t3 = dr_time_us();
+			step_time += t3 - t2;
+			step_max = max( step_max, t3 - t2 );
+			step_count ++;
+		}
+		sync_steps = steps * settings.get_frames_per_step() + network_frame_count;
+	}
+
+	if(  journal.is_broken()  ) {
+		dbg->error( "karte_t::replay_journal", "Journal %s is broken, replay stopped at sync_step %u", filename, sync_steps );
+		return false;
+	}
+
+	const uint64 total = dr_time_us() - replay_start;
+	cbuffer_t buf;
+	buf.printf( "Replayed %u commands over %u sync steps in %.3f s, %u checklists matched\n", journal.get_count(), sync_step_count, total / 1000000.0, checklist_count );
+	buf.printf( "  commands:  total %.3f ms\n", command_time / 1000.0 );
+	buf.printf( "  sync_step: total %.3f ms, mean %.1f us, max %.1f us\n", sync_step_time / 1000.0, sync_step_count ? (double)sync_step_time / sync_step_count : 0.0, (double)sync_step_max );
+	buf.printf( "  step:      total %.3f ms, mean %.1f us, max %.1f us (%u steps)\n", step_time / 1000.0, step_count ? (double)step_time / step_count : 0.0, (double)step_max, step_count );
+	dump_freelist_statistics( buf );
+	printf( "%s", buf.get_str() );
+	dbg->message( "karte_t::replay_journal", "%s", buf.get_str() );
+	return true;
+}
+
+
+void karte_t::run_steps(uint32 count)
+{
+	step_mode = FIX_RATIO;
+	reset_timer();
+
+	for(  uint32 i=0;  i<count;  i++  ) {
+		// a whole step worth of sync steps, then the step with all its threaded phases
+		for(  uint32 f=0;  f<settings.get_frames_per_step();  f++  ) {
+			sync_step( (fix_ratio_frame_time*time_multiplier)/16, true, false );
+		}
+		set_random_mode( STEP_RANDOM );
+		step();
+		clear_random_mode( STEP_RANDOM );
+		sync_steps = steps * settings.get_frames_per_step();
+	}
+}
+
+
+void karte_t::benchmark_steps(uint32 count)
+{
+	freelist_t::reset_statistics();
+	step_profiler_t::reset_totals();
+	const uint64 start = dr_time_us();
+	run_steps( count );
+	const uint64 total = dr_time_us() - start;
+
+	uint64 step_time;
+	uint32 step_max;
+	step_profiler_t::get_totals( step_profiler_t::STEP, step_time, step_max );
+
+	cbuffer_t buf;
+	buf.printf( "Ran %u steps in %.3f s\n", count, total / 1000000.0 );
+	buf.printf( "  step: total %.3f ms, mean %.1f us, max %.1f us\n", step_time / 1000.0, count ? (double)step_time / count : 0.0, (double)step_max );
+	dump_freelist_statistics( buf );
+	haltestelle_t::benchmark_connexion_tables( buf );
+	printf( "%s", buf.get_str() );
+	dbg->message( "karte_t::benchmark_steps", "%s", buf.get_str() );
+}
+
+
 // Announce server to central listing server
 // Status is one of:
 // 0 - startup
@@ -12108,3 +12506,107 @@ uint32 karte_t::get_gamestate_hash()
 	rdwr_gamestate(&ls, NULL);
 	return stream->get_hash();
 }
+
+
+void karte_t::calc_subsystem_hashes(uint32 *hashes, const char *log_name, uint32 log_step, uint32 slice, uint32 slice_count) const
+{
+	FILE *log = NULL;
+	if(  env_t::subsystem_hash_log  ) {
+		dr_mkdir( "desync" );
+		cbuffer_t name;
+		name.printf( "desync/statehash-%s.txt", log_name );
+		log = dr_fopen( name, "a" );
+	}
+
+	for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+		hashes[i] = CHK_HASH_INIT;
+	}
+
+	for(  uint32 i = slice;  i < convoi_array.get_count();  i += slice_count  ) {
+		convoihandle_t const cnv = convoi_array[i];
+		uint32 h = checklist_hash_add( CHK_HASH_INIT, cnv.get_id() );
+		h = checklist_hash_add( h, cnv->get_state() );
+		h = checklist_hash_add( h, cnv->get_akt_speed() );
+		h = checklist_hash_add( h, (uint32)cnv->get_total_distance_traveled() );
+		for(  uint8 v = 0;  v < cnv->get_vehicle_count();  v++  ) {
+			const vehicle_t *veh = cnv->get_vehicle(v);
+			const koord3d pos = veh->get_pos();
+			h = checklist_hash_add( h, ((uint32)(uint16)pos.x << 16) | (uint16)pos.y );
+			h = checklist_hash_add( h, ((uint32)(uint8)pos.z << 8) | veh->get_steps() );
+			h = checklist_hash_add( h, veh->get_total_cargo() );
+		}
+		hashes[CHK_SUB_CONVOYS] = checklist_hash_add( hashes[CHK_SUB_CONVOYS], h );
+		if(  log  ) {
+			fprintf( log, "%u convoys %u %08x\n", log_step, cnv.get_id(), h );
+		}
+	}
+
+	for(  uint32 i = slice;  i < haltestelle_t::get_alle_haltestellen().get_count();  i += slice_count  ) {
+		halthandle_t const halt = haltestelle_t::get_alle_haltestellen()[i];
+		const uint32 h = halt->get_cargo_hash();
+		hashes[CHK_SUB_HALTS] = checklist_hash_add( hashes[CHK_SUB_HALTS], h );
+		if(  log  ) {
+			fprintf( log, "%u halts %u %08x\n", log_step, halt.get_id(), h );
+		}
+	}
+
+	for(  uint32 i = slice;  i < fab_list.get_count();  i += slice_count  ) {
+		fabrik_t* const fab = fab_list[i];
+		const koord3d pos = fab->get_pos();
+		uint32 h = checklist_hash_add( CHK_HASH_INIT, ((uint32)(uint16)pos.x << 16) | (uint16)pos.y );
+		h = checklist_hash_add( h, fab->get_total_in() );
+		h = checklist_hash_add( h, fab->get_total_out() );
+		for(ware_production_t const& ware : fab->get_input()) {
+			h = checklist_hash_add( h, ware.menge );
+		}
+		for(ware_production_t const& ware : fab->get_output()) {
+			h = checklist_hash_add( h, ware.menge );
+		}
+		hashes[CHK_SUB_FACTORIES] = checklist_hash_add( hashes[CHK_SUB_FACTORIES], h );
+		if(  log  ) {
+			fprintf( log, "%u factories %s %08x\n", log_step, pos.get_str(), h );
+		}
+	}
+
+	for(  uint32 i = slice;  i < cities.get_count();  i += slice_count  ) {
+		stadt_t* const city = cities[i];
+		const koord pos = city->get_pos();
+		uint32 h = checklist_hash_add( CHK_HASH_INIT, ((uint32)(uint16)pos.x << 16) | (uint16)pos.y );
+		h = checklist_hash_add( h, city->get_city_population() );
+		h = checklist_hash_add( h, city->get_buildings() );
+		h = checklist_hash_add( h, city->get_unemployed() );
+		h = checklist_hash_add( h, city->get_homeless() );
+		hashes[CHK_SUB_CITIES] = checklist_hash_add( hashes[CHK_SUB_CITIES], h );
+		if(  log  ) {
+			fprintf( log, "%u cities %s %08x\n", log_step, pos.get_str(), h );
+		}
+	}
+
+	for(  uint32 i = slice;  i < weg_t::get_alle_wege().get_count();  i += slice_count  ) {
+		weg_t* const way = weg_t::get_alle_wege()[i];
+		const koord3d pos = way->get_pos();
+		uint32 h = checklist_hash_add( CHK_HASH_INIT, ((uint32)(uint16)pos.x << 16) | (uint16)pos.y );
+		h = checklist_hash_add( h, ((uint32)(uint8)pos.z << 8) | way->get_waytype() );
+		h = checklist_hash_add( h, way->get_remaining_wear_capacity() );
+		h = checklist_hash_add( h, way->get_max_speed() );
+		h = checklist_hash_add( h, way->get_statistics( WAY_STAT_THIS_MONTH, WAY_STAT_CONVOIS ) );
+		hashes[CHK_SUB_WAYS] = checklist_hash_add( hashes[CHK_SUB_WAYS], h );
+		if(  log  ) {
+			fprintf( log, "%u ways %s/%u %08x\n", log_step, pos.get_str(), way->get_waytype(), h );
+		}
+	}
+
+	for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+		// zero is reserved for "not calculated"
+		if(  hashes[i] == 0  ) {
+			hashes[i] = 1;
+		}
+		if(  log  ) {
+			fprintf( log, "%u total %s %08x\n", log_step, checklist_t::get_subsystem_name(i), hashes[i] );
+		}
+	}
+
+	if(  log  ) {
+		fclose( log );
+	}
+}
@@ -641,6 +641,39 @@ private:
 	 */
 	uint32 tile_counter;
 
+	/**
+	 * Next tile for the monthly wear of the ways, which is spread over the
+	 * steps after the month change. WAY_MONTH_DONE if nothing is pending.
+	 */
+	uint32 way_month_tile;
+	enum { WAY_MONTH_DONE = 0xFFFFFFFFu };
+
+	/**
+	 * Calls weg_t::new_month() for the ways on the next chunk of tiles
+	 * @param finish process all remaining tiles at once
+	 */
+	void step_way_month(bool finish);
+
+	/**
+	 * Steps all factories: the production and the choice of the destinations
+	 * run in parallel (world_xy_loop, factories split by position), then the
+	 * goods are handed to the halts in the order of fab_list.
+	 */
+	void step_factories(uint32 delta_t);
+	void step_factories_production_loop(sint16, sint16, sint16, sint16);
+	void step_factories_plan_loop(sint16, sint16, sint16, sint16);
+
+	/// delta_t of the current step_factories() for the loops
+	uint32 factory_step_delta_t;
+
+	/**
+	 * Steps all players. The read-only planning of the AI players runs in
+	 * parallel (world_xy_loop, their objects split by position), their
+	 * actions then one player after another.
+	 */
+	void step_players();
+	void step_players_plan_loop(sint16, sint16, sint16, sint16);
+
 	/**
 	 * To identify different stages of the same game.
 	 */
@@ -2388,6 +2421,28 @@ public:
 
 	bool interactive(uint32 quit_month);
 
+	/**
+	 * Applies the commands of a command journal (see command_journal_t) at full speed
+	 * and without display, stepping like a network server, and reports the time
+	 * spent in sync_step() and step().
+	 * @returns false, if the journal could not be opened or read, or if the replay
+	 * did not arrive at the recorded checklists
+	 */
+	bool replay_journal(const char *filename);
+
+	/**
+	 * Runs @p count steps (with their sync steps) at full speed and without display,
+	 * stepping like a network game does.
+	 */
+	void run_steps(uint32 count);
+
+	/**
+	 * Runs @p count steps with run_steps()
+	 * and reports the step times, the allocation statistics of the freelist
+	 * and the throughput of the connexion tables of the halts.
+	 */
+	void benchmark_steps(uint32 count);
+
 	uint32 get_sync_steps() const { return sync_steps; }
 
 	/**
@@ -2447,6 +2502,18 @@ public:
 	 */
 	uint32 get_gamestate_hash();
 
+	/**
+	 * Calculates one state hash per subsystem (see checklist_subsystem_t) into @p hashes.
+	 * Each subsystem hash is the combination of the hashes of its objects, so a mismatch
+	 * can be narrowed down to single objects by comparing the logs written with env_t::subsystem_hash_log.
+	 * @param log_name suffix of the log file; the log records are tagged with @p log_step
+	 * @param slice only the objects with index % @p slice_count == @p slice are hashed
+	 */
+	void calc_subsystem_hashes(uint32 *hashes, const char *log_name, uint32 log_step, uint32 slice = 0, uint32 slice_count = 1) const;
+
+	/// the checklist of the current sync step, with the subsystem hashes when they are due
+	checklist_t calc_checklist(const char *log_name);
+
 	/**
 	 * Time printing routines.
 	 * Should be inlined.
@@ -107,6 +107,11 @@ SQRESULT sq_get_ops_remaing(HSQUIRRELVM v)
 	return 1;
 }
 
+SQInteger sq_get_ops_executed(HSQUIRRELVM v)
+{
+	return v->_ops_total;
+}
+
 void sq_block_suspend(HSQUIRRELVM v, const char* f)
 {
 	if (my_vm_info_t* i = vm_info.access(v)) {
@@ -71,4 +71,10 @@ SQRESULT sq_get_ops_total(HSQUIRRELVM v);
 /// @returns amount of remaining opcodes until vm will be suspended
 SQRESULT sq_get_ops_remaing(HSQUIRRELVM v);
 
+/// @returns total amount of opcodes executed by vm (not pushed onto the stack)
+SQInteger sq_get_ops_executed(HSQUIRRELVM v);
+
+/// @returns number of memory allocations of all vm's so far (defined in sqmem.cc)
+SQUnsignedInteger sq_get_allocations();
+
 #endif
@@ -2,10 +2,15 @@
 	see copyright notice in squirrel.h
 */
 #include "sqpcheader.h"
+// simutrans: number of allocations, used by the script profiler
+static SQUnsignedInteger _sq_allocations = 0;
+
+SQUnsignedInteger sq_get_allocations(){ return _sq_allocations; }
+
 #ifndef SQ_EXCLUDE_DEFAULT_MEMFUNCTIONS
-void *sq_vm_malloc(SQUnsignedInteger size){ return malloc(size); }
+void *sq_vm_malloc(SQUnsignedInteger size){ _sq_allocations++; return malloc(size); }
 
-void *sq_vm_realloc(void *p, SQUnsignedInteger SQ_UNUSED_ARG(oldsize), SQUnsignedInteger size){ return realloc(p, size); }
+void *sq_vm_realloc(void *p, SQUnsignedInteger SQ_UNUSED_ARG(oldsize), SQUnsignedInteger size){ _sq_allocations++; return realloc(p, size); }
 
 void sq_vm_free(void *p, SQUnsignedInteger SQ_UNUSED_ARG(size)){ free(p); }
 #endif
@@ -9,6 +9,7 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <chrono>
 
 #ifdef __HAIKU__
 #include <Message.h>
@@ -34,6 +35,10 @@
 #	include <winbase.h>
 #	include <shellapi.h>
 #	include <shlobj.h>
+#	include <psapi.h>
+#	ifdef _MSC_VER
+#		pragma comment(lib, "psapi.lib")
+#	endif
 #	if !defined(__CYGWIN__)
 #		include <direct.h>
 #	else
@@ -43,6 +48,8 @@
 #else
 #	include <limits.h>
 #	include <dirent.h>
+#	include <fcntl.h>
+#	include <sys/resource.h>
 #	if !defined __AMIGA__ && !defined __BEOS__
 #		include <unistd.h>
 #	endif
@@ -124,6 +131,38 @@ scr_coord get_mouse_pos()
 }
 
 
+uint64 dr_time_us()
+{
+	return (uint64)std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+
+uint64 dr_get_peak_memory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS pmc;
+	if(  GetProcessMemoryInfo( GetCurrentProcess(), &pmc, sizeof(pmc) )  ) {
+		return pmc.PeakWorkingSetSize;
+	}
+	return 0;
+#elif defined __AMIGA__ || defined __BEOS__ || defined __HAIKU__
+	return 0;
+#else
+	struct rusage usage;
+	if(  getrusage( RUSAGE_SELF, &usage ) != 0  ) {
+		return 0;
+	}
+#	ifdef __APPLE__
+	// already in bytes
+	return (uint64)usage.ru_maxrss;
+#	else
+	// in kilobytes
+	return (uint64)usage.ru_maxrss * 1024;
+#	endif
+#endif
+}
+
+
 
 // create a directory with all subdirectories needed
 int dr_mkdir(char const* const path)
@@ -336,6 +375,20 @@ int dr_stat(const char *path, struct stat *buf)
 #endif
 }
 
+void dr_prefetch_file(const char *path)
+{
+#if !defined(_WIN32) && defined(POSIX_FADV_WILLNEED)
+	// the kernel starts reading the whole file in the background
+	const int fd = open(path, O_RDONLY);
+	if(  fd >= 0  ) {
+		posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+		close(fd);
+	}
+#else
+	(void)path;
+#endif
+}
+
 char const *dr_query_homedir()
 {
 	static char buffer[PATH_MAX + 24];
@@ -148,6 +148,9 @@ gzFile dr_gzopen(const char *path, const char *mode);
 // Functions the same as stat except path must be UTF-8 encoded.
 int dr_stat(const char *path, struct stat *buf);
 
+// Hint to the OS that the file will be read soon (may do nothing), path must be UTF-8 encoded.
+void dr_prefetch_file(const char *path);
+
 /* query home directory */
 char const* dr_query_homedir();
 
@@ -189,6 +192,12 @@ void GetEvents();
 uint32 dr_time();
 void dr_sleep(uint32 millisec);
 
+/// monotonic time in microseconds, for profiling (the zero point is arbitrary)
+uint64 dr_time_us();
+
+/// peak resident memory of the process in bytes (0 if unknown)
+uint64 dr_get_peak_memory();
+
 // error message in case of fatal events
 void dr_fatal_notify(char const* msg);
 
@@ -0,0 +1,378 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef TPL_FLAT_HASHTABLE_TPL_H
+#define TPL_FLAT_HASHTABLE_TPL_H
+
+
+#include <iterator>
+#include <new>
+#include <string.h>
+
+#include "../simmem.h"
+#include "../simtypes.h"
+#include "../simdebug.h"
+
+
+/*
+ * Hashtable with the interface of hashtable_tpl, but storing the entries in
+ * one flat array (open addressing with linear probing) instead of lists of
+ * nodes in a fixed number of bags. The array grows and shrinks with the
+ * number of entries; an empty table allocates nothing.
+ *
+ * hash_t is the same as for hashtable_tpl (see inthashtable_tpl.h etc.).
+ * The game iterates over some of these tables (e.g. the connexions of a halt),
+ * so the iteration order must not depend on the history of the table (this
+ * would desync network games or change after loading): the number of slots
+ * depends only on the number of entries, and within a cluster the entries are
+ * kept ordered by their home slot and then by their hash (Robin Hood
+ * insertion, removal shifts the cluster back). Thus the order depends only on
+ * the contents, as long as different keys have different hashes.
+ * Iterators become invalid on any insertion or removal.
+ */
+template<class key_t, class value_t, class hash_t>
+class flat_hashtable_tpl
+{
+protected:
+	struct node_t {
+	public:
+		key_t   key;
+		value_t value;
+
+		int operator == (const node_t &x) const { return key == x.key; }
+	};
+
+	enum { EMPTY = 0, USED = 1 };
+
+	/// entries, only those with state USED are constructed
+	node_t *nodes;
+	uint8 *states;
+
+	/// number of slots (a power of two, or 0)
+	uint32 size;
+	/// number of allocated slots, at least size (kept after clear())
+	uint32 capacity;
+	/// 32 - log2(size)
+	uint8 shift;
+	/// number of used slots
+	uint32 count;
+
+private:
+	flat_hashtable_tpl(const flat_hashtable_tpl&);
+	flat_hashtable_tpl& operator=( flat_hashtable_tpl const&);
+
+	// Fibonacci hashing, as the hashes of hash_t are often just the key
+	// (and pointers have their lowest bits zero): use the upper bits
+	uint32 get_slot(const key_t key) const
+	{
+		return (uint32)((uint32)hash_t::hash(key) * 2654435769u) >> shift;
+	}
+
+	/// how far the entry in slot i is away from its home slot
+	uint32 get_distance(uint32 i) const
+	{
+		return (i - get_slot(nodes[i].key)) & (size-1);
+	}
+
+	/// @returns slot of key, or size if not contained
+	uint32 find(const key_t key) const
+	{
+		if(  count == 0  ) {
+			return size;
+		}
+		uint32 dist = 0;
+		for(  uint32 i = get_slot(key);  states[i] != EMPTY;  i = (i+1) & (size-1), dist++  ) {
+			if(  hash_t::comp(nodes[i].key, key) == 0  ) {
+				return i;
+			}
+			if(  get_distance(i) < dist  ) {
+				// key would have been placed before this entry
+				break;
+			}
+		}
+		return size;
+	}
+
+	/// places node n (its key not contained) in its ordered position, the count is not changed
+	void insert_node(node_t n)
+	{
+		uint32 dist = 0;
+		uint32 i = get_slot(n.key);
+		while(  states[i] == USED  ) {
+			const uint32 other = get_distance(i);
+			if(  other < dist  ||  (other == dist  &&  (uint32)hash_t::hash(n.key) < (uint32)hash_t::hash(nodes[i].key))  ) {
+				// n comes first, continue with the displaced entry
+				node_t tmp = nodes[i];
+				nodes[i] = n;
+				n = tmp;
+				dist = other;
+			}
+			i = (i+1) & (size-1);
+			dist ++;
+		}
+		new (&nodes[i]) node_t(n);
+		states[i] = USED;
+	}
+
+	void rehash(uint32 new_size)
+	{
+		node_t *old_nodes = nodes;
+		uint8 *old_states = states;
+		const uint32 old_size = size;
+
+		size = new_size;
+		shift = 32;
+		for(  uint32 n = new_size;  n > 1;  n >>= 1  ) {
+			shift --;
+		}
+		if(  count == 0  &&  new_size <= capacity  ) {
+			// nothing to move, reuse the arrays
+			memset( states, EMPTY, new_size );
+			return;
+		}
+
+		nodes = (node_t *)xmalloc( sizeof(node_t) * new_size );
+		states = MALLOCN(uint8, new_size);
+		memset( states, EMPTY, new_size );
+		capacity = new_size;
+		for(  uint32 i = 0;  i < old_size;  i++  ) {
+			if(  old_states[i] == USED  ) {
+				insert_node( old_nodes[i] );
+				old_nodes[i].~node_t();
+			}
+		}
+		free( old_nodes );
+		free( old_states );
+	}
+
+	/// adds a new entry (key must not be contained)
+	void insert(const key_t key, const value_t &object)
+	{
+		// keep at most 70% of the slots used
+		if(  (count + 1) * 10 > size * 7  ) {
+			rehash( size < 8 ? 8 : size*2 );
+		}
+		node_t n = { key, object };
+		insert_node( n );
+		count ++;
+	}
+
+	void erase_slot(uint32 i)
+	{
+		nodes[i].~node_t();
+		// shift the rest of the cluster back, so no tombstone is needed
+		for(  uint32 j = (i+1) & (size-1);  states[j] == USED  &&  get_distance(j) > 0;  j = (j+1) & (size-1)  ) {
+			new (&nodes[i]) node_t(nodes[j]);
+			nodes[j].~node_t();
+			i = j;
+		}
+		states[i] = EMPTY;
+		count --;
+		// shrink as soon as the half size would do, so the size depends only on the count
+		if(  count == 0  ) {
+			size = 0;
+			shift = 32;
+		}
+		else if(  size > 8  &&  count * 10 <= (size / 2) * 7  ) {
+			rehash( size / 2 );
+		}
+	}
+
+public:
+	flat_hashtable_tpl() : nodes(NULL), states(NULL), size(0), capacity(0), shift(32), count(0) {}
+
+	~flat_hashtable_tpl()
+	{
+		clear();
+		free( nodes );
+		free( states );
+	}
+
+	class iterator
+	{
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef node_t                    value_type;
+		typedef ptrdiff_t                 difference_type;
+		typedef node_t*                   pointer;
+		typedef node_t&                   reference;
+
+		iterator() : table(NULL), i(0) {}
+
+		iterator(flat_hashtable_tpl *table, uint32 i) : table(table), i(i) { skip(); }
+
+		pointer   operator ->() const { return &table->nodes[i]; }
+		reference operator *()  const { return  table->nodes[i]; }
+
+		iterator& operator ++()
+		{
+			i ++;
+			skip();
+			return *this;
+		}
+
+		bool operator ==(iterator const& o) const { return i == o.i; }
+		bool operator !=(iterator const& o) const { return i != o.i; }
+
+	private:
+		void skip()
+		{
+			while(  i < table->size  &&  table->states[i] != USED  ) {
+				i ++;
+			}
+		}
+
+		flat_hashtable_tpl *table;
+		uint32 i;
+	};
+
+	class const_iterator
+	{
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef node_t                    value_type;
+		typedef ptrdiff_t                 difference_type;
+		typedef node_t const*             pointer;
+		typedef node_t const&             reference;
+
+		const_iterator() : table(NULL), i(0) {}
+
+		const_iterator(flat_hashtable_tpl const *table, uint32 i) : table(table), i(i) { skip(); }
+
+		pointer   operator ->() const { return &table->nodes[i]; }
+		reference operator *()  const { return  table->nodes[i]; }
+
+		const_iterator& operator ++()
+		{
+			i ++;
+			skip();
+			return *this;
+		}
+
+		bool operator ==(const_iterator const& o) const { return i == o.i; }
+		bool operator !=(const_iterator const& o) const { return i != o.i; }
+
+	private:
+		void skip()
+		{
+			while(  i < table->size  &&  table->states[i] != USED  ) {
+				i ++;
+			}
+		}
+
+		flat_hashtable_tpl const *table;
+		uint32 i;
+	};
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, size); }
+
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, size); }
+
+	void clear()
+	{
+		for(  uint32 i = 0;  i < size;  i++  ) {
+			if(  states[i] == USED  ) {
+				nodes[i].~node_t();
+			}
+			states[i] = EMPTY;
+		}
+		count = 0;
+		// the next insert starts again with the smallest size
+		size = 0;
+		shift = 32;
+	}
+
+	const value_t &get(const key_t key) const
+	{
+		static value_t nix;
+		const uint32 i = find(key);
+		return i < size ? nodes[i].value : nix;
+	}
+
+	value_t *access(const key_t key)
+	{
+		const uint32 i = find(key);
+		return i < size ? &nodes[i].value : NULL;
+	}
+
+	/// Inserts a new value - failure if key exists in table
+	bool put(const key_t key, value_t object)
+	{
+		if(  find(key) < size  ) {
+			return false;
+		}
+		insert( key, object );
+		return true;
+	}
+
+	bool is_contained(const key_t key) const
+	{
+		return find(key) < size;
+	}
+
+	// Inserts a new instantiated value - failure, if key exists in table
+	bool put(const key_t key)
+	{
+		if(  find(key) < size  ) {
+			return false;
+		}
+		insert( key, value_t() );
+		return true;
+	}
+
+	// Insert or replace a value - if a value is replaced, the old value is
+	// returned, otherwise a nullvalue.
+	value_t set(const key_t key, value_t object)
+	{
+		const uint32 found = find(key);
+		if(  found < size  ) {
+			value_t value = nodes[found].value;
+			nodes[found].value = object;
+			return value;
+		}
+		insert( key, object );
+		return value_t();
+	}
+
+	// Remove an entry - if the entry is not there, return a nullvalue
+	// otherwise the value that was associated to the key.
+	value_t remove(const key_t key)
+	{
+		const uint32 i = find(key);
+		if(  i == size  ) {
+			return value_t();
+		}
+		value_t v = nodes[i].value;
+		erase_slot(i);
+		return v;
+	}
+
+	value_t remove_first()
+	{
+		for(  uint32 i = 0;  i < size;  i++  ) {
+			if(  states[i] == USED  ) {
+				value_t v = nodes[i].value;
+				erase_slot(i);
+				return v;
+			}
+		}
+		dbg->fatal( "flat_hashtable_tpl::remove_first()", "Hashtable already empty!" );
+		return value_t();
+	}
+
+	uint32 get_count() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return get_count()==0;
+	}
+};
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef TPL_INDEXED_HEAP_TPL_H
+#define TPL_INDEXED_HEAP_TPL_H
+
+
+#include "../simmem.h"
+#include "../simtypes.h"
+
+
+/**
+ * Binary heap of pointers to nodes like binary_heap_tpl, but every node
+ * keeps its position in the heap in its member heap_index. Thus a node
+ * already in the heap can be moved up when its key decreased, instead of
+ * inserting it a second time.
+ *
+ * T must be a pointer to a class with a uint32 heap_index and operator <=.
+ * heap_index is 0 for nodes not in the heap.
+ */
+template <class T>
+class indexed_heap_tpl
+{
+private:
+	T *nodes;
+
+	uint32 node_count;
+	uint32 node_size;
+
+	// moves the item at gap towards the root until its parent is smaller
+	void sift_up(uint32 gap, const T item)
+	{
+		for(  uint32 parent = gap/2;  parent>0  &&  *item <= *nodes[parent];  parent /= 2  ) {
+			nodes[gap] = nodes[parent];
+			nodes[gap]->heap_index = gap;
+			gap = parent;
+		}
+		nodes[gap] = item;
+		item->heap_index = gap;
+	}
+
+public:
+	indexed_heap_tpl()
+	{
+		nodes = MALLOCN(T, 4096);
+		node_size = 4096;
+		node_count = 0;
+	}
+
+	~indexed_heap_tpl()
+	{
+		free( nodes );
+	}
+
+	void insert(const T item)
+	{
+		node_count ++;
+
+		// need to enlarge? (must be 2^x)
+		if(  node_count == node_size  ) {
+			T *tmp = nodes;
+			node_size *= 2;
+			nodes = MALLOCN(T, node_size);
+			memcpy( nodes, tmp, sizeof(T)*(node_size/2) );
+			free( tmp );
+		}
+		sift_up( node_count, item );
+	}
+
+	/**
+	 * Restores the heap order after the key of @p item (which must be in
+	 * the heap) was lowered.
+	 */
+	void decrease_key(const T item)
+	{
+		assert( item->heap_index > 0  &&  nodes[item->heap_index] == item );
+		sift_up( item->heap_index, item );
+	}
+
+	T pop()
+	{
+		assert(!empty());
+
+		T result = nodes[1];
+		result->heap_index = 0;
+
+		// this is the last one
+		T item = nodes[node_count--];
+
+		// now we must maintain relation between parent and its children:
+		//   parent <= any child
+		uint32 gap = 1;
+		uint32 child = 2;
+		while(  child <= node_count  ) {
+			// choose the smaller child
+			if(  child < node_count  &&  *nodes[child+1] <= *nodes[child]  ) {
+				child++;
+			}
+			if(  !(*nodes[child] <= *item)  ) {
+				break;
+			}
+			nodes[gap] = nodes[child];
+			nodes[gap]->heap_index = gap;
+			gap = child;
+			child = gap * 2;
+		}
+		if(  node_count > 0  ) {
+			nodes[gap] = item;
+			item->heap_index = gap;
+		}
+
+		return result;
+	}
+
+	/// Leaves the heap empty (the nodes keep their stale heap_index)
+	void clear() { node_count = 0; }
+
+	uint32 get_count() const { return node_count; }
+
+	bool empty() const { return node_count == 0; }
+
+	const T& front() const
+	{
+		assert(!empty());
+		return nodes[1];
+	}
+
+private:
+	indexed_heap_tpl(const indexed_heap_tpl& other);
+	indexed_heap_tpl& operator=( indexed_heap_tpl const& other );
+};
+
+#endif
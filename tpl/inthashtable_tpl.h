@@ -8,6 +8,7 @@
 
 
 #include "hashtable_tpl.h"
+#include "flat_hashtable_tpl.h"
 
 /**
  * Define type for differences of integers.
@@ -59,4 +60,17 @@ private:
 	inthashtable_tpl& operator=( inthashtable_tpl const&);
 };
 
+/*
+ * Same as inthashtable_tpl, but with open addressing (see flat_hashtable_tpl.h)
+ */
+template<class key_t, class value_t>
+class flat_inthashtable_tpl : public flat_hashtable_tpl<key_t, value_t, inthash_tpl<key_t> >
+{
+public:
+	flat_inthashtable_tpl() : flat_hashtable_tpl<key_t, value_t, inthash_tpl<key_t> >() {}
+private:
+	flat_inthashtable_tpl(const flat_inthashtable_tpl&);
+	flat_inthashtable_tpl& operator=( flat_inthashtable_tpl const&);
+};
+
 #endif
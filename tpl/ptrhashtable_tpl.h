@@ -8,6 +8,7 @@
 
 
 #include "hashtable_tpl.h"
+#include "flat_hashtable_tpl.h"
 #include "../simtypes.h"
 
 
@@ -52,4 +53,17 @@ private:
 	ptrhashtable_tpl& operator=( ptrhashtable_tpl const&);
 };
 
+/*
+ * Same as ptrhashtable_tpl, but with open addressing (see flat_hashtable_tpl.h)
+ */
+template<class key_t, class value_t>
+class flat_ptrhashtable_tpl : public flat_hashtable_tpl<key_t, value_t, ptrhash_tpl<key_t> >
+{
+public:
+	flat_ptrhashtable_tpl() : flat_hashtable_tpl<key_t, value_t, ptrhash_tpl<key_t> >() {}
+private:
+	flat_ptrhashtable_tpl(const flat_ptrhashtable_tpl&);
+	flat_ptrhashtable_tpl& operator=( flat_ptrhashtable_tpl const&);
+};
+
 #endif
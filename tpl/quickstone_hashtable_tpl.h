@@ -9,6 +9,7 @@
 
 #include "inthashtable_tpl.h"
 #include "hashtable_tpl.h"
+#include "flat_hashtable_tpl.h"
 #include "quickstone_tpl.h"
 
 #include <stdlib.h>
@@ -53,4 +54,12 @@ class quickstone_hashtable_tpl : public hashtable_tpl<quickstone_tpl<key_t>, val
 {
 };
 
+/**
+ * Same as quickstone_hashtable_tpl, but with open addressing (see flat_hashtable_tpl.h)
+ */
+template<class key_t, class value_t>
+class flat_quickstone_hashtable_tpl : public flat_hashtable_tpl<quickstone_tpl<key_t>, value_t, quickstone_hash_tpl<key_t> >
+{
+};
+
 #endif
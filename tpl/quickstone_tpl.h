@@ -10,13 +10,20 @@
 #include "../simtypes.h"
 #include "../simdebug.h"
 
+#include <string.h>
+
 /**
  * An implementation of the tombstone pointer checking method.
  * It uses a table of pointers and indices into that table to
  * implement the tombstone system. Unlike real tombstones, this
  * template reuses entries from the tombstone table, but it tries
  * to leave freed  tombstones untouched as long as possible, to
- * detect most of the dangling pointers.
+ * detect most of the dangling pointers: never used entries are handed
+ * out first, and freed ones are reused in the order they were freed.
+ *
+ * In debug builds every handle also remembers the generation of its entry,
+ * which is increased whenever the entry is freed, so a handle to a deleted
+ * object is reported even after its entry has been reused.
  *
  * This templates goal is to be efficient and fairly safe.
  */
@@ -38,40 +45,109 @@ private:
 	 */
 	static uint16 size;
 
+	/**
+	 * Freed entries in the order they were freed, as a ring buffer of
+	 * size entries (an entry can only be queued once per detach).
+	 */
+	static uint16 *free_queue;
+	static uint16 free_first;
+	static uint16 free_count;
+
+#ifdef DEBUG
+	/**
+	 * Generation of each entry, increased when the entry is freed
+	 */
+	static uint8 *generations;
+#endif
+
 	/**
 	 * The index in the table for this handle.
 	 * (only this variable is actually saved, since the rest is static!)
 	 */
 	uint16 entry;
 
+#ifdef DEBUG
+	uint8 generation;
+
+	// the null handle may be created before init()
+	void set_entry(uint16 e) { entry = e; generation = e ? generations[e] : 0; }
+
+	void check_generation() const
+	{
+		if(  data[entry]  &&  generation != generations[entry]  ) {
+			dbg->error("quickstone<T>", "stale handle to reused slot %u", (unsigned)entry);
+		}
+	}
+#else
+	void set_entry(uint16 e) { entry = e; }
+
+	void check_generation() const {}
+#endif
+
 private:
+	static void queue_free(uint16 i)
+	{
+		if(  i >= next  ) {
+			// will be found by find_next() anyway
+			return;
+		}
+		if(  free_count >= size-1  ) {
+			// only possible with duplicates from explicitly set ids
+			requeue_free();
+			return;
+		}
+		uint16 pos = free_first + free_count;
+		if(  pos >= size  ) {
+			pos -= size;
+		}
+		free_queue[pos] = i;
+		free_count++;
+	}
+
+	/**
+	 * Queues all free entries below next in index order, after the list was
+	 * lost by loading (or by setting ids explicitly).
+	 */
+	static void requeue_free()
+	{
+		free_first = 0;
+		free_count = 0;
+		for(  uint16 i=1;  i<next  &&  i<size;  i++  ) {
+			if(  data[i] == 0  ) {
+				free_queue[free_count++] = i;
+			}
+		}
+	}
+
 	/**
 	 * Retrieves next free tombstone index
 	 */
 	static uint16 find_next() {
-		uint16 i;
-
-		// scan rest of array
-		for(  i=next;  i<size;  i++  ) {
-			if(  data[i] == 0  ) {
-				next = i+1;
-				return i;
+		// never used entries first
+		while(  next < size  ) {
+			if(  data[next] == 0  ) {
+				return next++;
 			}
+			next++;
 		}
 
-		if (size < 65535)
-		{
-			// Enlarge the array before searching old handles.
+		if(  size < 65535  ) {
+			// Enlarge the array before reusing old handles.
 			// This is slightly less efficient, but minimises handle
 			// duplication, which can cause problems when handles are
 			// used as indices.
 			return enlarge();
 		}
 
-		// scan whole array
-		for(  i=1;  i<size;  i++  ) {
-			if(  data[i]==0  ) {
-				next = i+1;
+		// then the entry freed longest ago
+		if(  free_count == 0  ) {
+			requeue_free();
+		}
+		while(  free_count > 0  ) {
+			const uint16 i = free_queue[free_first];
+			free_first = free_first+1 < size ? free_first+1 : 0;
+			free_count--;
+			if(  data[i] == 0  ) {
 				return i;
 			}
 		}
@@ -82,14 +158,16 @@ private:
 	{
 		// no free entry found, extend array if possible
 		uint16 newsize;
-		if (size == 65535) {
+		if(  size == 65535  ) {
 			// completely out of handles
-			dbg->fatal("quickstone<T>::find_next()","no free index found (size=%i)",size);
+			dbg->fatal("quickstone<T>::find_next()","no free index found (size=%u)",(unsigned)size);
 			return 0; //dummy for compiler
-		} else if (size >= 32768) {
+		}
+		else if(  size >= 32768  ) {
 			// max out on handles, don't overflow uint16
 			newsize = 65535;
-		} else {
+		}
+		else {
 			newsize = 2*size;
 		}
 
@@ -101,6 +179,25 @@ private:
 		}
 		delete [] data;
 		data = newdata;
+
+		// unwrap the queue of freed entries into the larger ring
+		uint16 *newqueue = new uint16 [newsize];
+		for(  uint16 i=0;  i<free_count;  i++  ) {
+			const uint16 pos = free_first+i;
+			newqueue[i] = free_queue[pos < size ? pos : pos-size];
+		}
+		delete [] free_queue;
+		free_queue = newqueue;
+		free_first = 0;
+
+#ifdef DEBUG
+		uint8 *newgenerations = new uint8 [newsize];
+		memcpy( newgenerations, generations, size );
+		memset( newgenerations+size, 0, newsize-size );
+		delete [] generations;
+		generations = newgenerations;
+#endif
+
 		next = size+1;
 		size = newsize;
 		return next-1;
@@ -120,52 +217,55 @@ public:
 		data = new T* [size];
 
 		// all NULL pointers are mapped to entry 0
-		for(int i=0; i<size; i++) {
+		for(  uint16 i=0;  i<size;  i++  ) {
 			data[i] = 0;
 		}
 		next = 1;
+
+		delete [] free_queue;
+		free_queue = new uint16 [size];
+		free_first = 0;
+		free_count = 0;
+
+#ifdef DEBUG
+		delete [] generations;
+		generations = new uint8 [size];
+		memset( generations, 0, size );
+#endif
 	}
 
 	// empty handle (entry 0 is always zero)
 	quickstone_tpl()
 	{
-		entry = 0;
+		set_entry(0);
 	}
 
 	// connects with free handle
 	explicit quickstone_tpl(T* p)
 	{
 		if(p) {
-			entry = find_next();
+			set_entry( find_next() );
 			data[entry] = p;
 		}
 		else {
 			// all NULL pointers are mapped to entry 0
-			entry = 0;
+			set_entry(0);
 		}
 	}
 
 	// connects with last handle
 	explicit quickstone_tpl(T* p, bool)
 	{
-		uint16 i;
-
-		// scan rest of array
-		for(  i=size-1;  i>0;  i++  ) {
-			if(  data[i] == 0  ) {
-				entry = i;
-				data[entry] = p;
-				return;
-			}
-		}
-		enlarge();
-		// repeat
-		for(  i=size-1;  i>0;  i++  ) {
-			if(  data[i] == 0  ) {
-				entry = i;
-				data[entry] = p;
-				return;
+		for(  int pass=0;  pass<2;  pass++  ) {
+			// scan array from the end
+			for(  uint16 i=size-1;  i>0;  i--  ) {
+				if(  data[i] == 0  ) {
+					set_entry(i);
+					data[entry] = p;
+					return;
+				}
 			}
+			enlarge();
 		}
 		dbg->fatal( "quickstone_tpl(bool)", "No more handles!\nShould have already failed with enlarge!" );
 	}
@@ -181,9 +281,9 @@ public:
 				enlarge();
 			}
 			if(  data[id]!=NULL  &&  data[id]!=p  ) {
-				dbg->fatal("quickstone<T>::quickstone_tpl(T*,uint16)","slot (%d) already taken", id);
+				dbg->fatal("quickstone<T>::quickstone_tpl(T*,uint16)","slot (%u) already taken", (unsigned)id);
 			}
-			entry = id;
+			set_entry(id);
 			data[entry] = p;
 		}
 		else {
@@ -191,7 +291,7 @@ public:
 				dbg->fatal("quickstone<T>::quickstone_tpl(T*,uint16)","wants to assign null pointer to non-null index");
 			}
 			// all NULL pointers are mapped to entry 0
-			entry = 0;
+			set_entry(0);
 		}
 	}
 
@@ -199,7 +299,9 @@ public:
 	static bool is_exhausted()
 	{
 		if(  size==65535  ) {
-			// scan  array
+			if(  next < size  ) {
+				return false;
+			}
 			for(  uint16 i = 1; i<size; i++) {
 				if(data[i] == 0) {
 					// still empty handles left
@@ -216,6 +318,7 @@ public:
 
 	inline bool is_bound() const
 	{
+		check_generation();
 		return data[entry] != 0;
 	}
 
@@ -231,7 +334,13 @@ public:
 	T* detach()
 	{
 		T* p = data[entry];
-		data[entry] = 0;
+		if(  p  ) {
+			data[entry] = 0;
+#ifdef DEBUG
+			generations[entry]++;
+#endif
+			queue_free(entry);
+		}
 		return p;
 	}
 
@@ -242,7 +351,7 @@ public:
 	 * are never ever deleted or that by some means detach() is called
 	 * upon deletion, i.e. from the ~T() destructor!!!
 	 */
-	T* get_rep() const { return data[entry]; }
+	T* get_rep() const { check_generation(); return data[entry]; }
 
 	/**
 	 * @return the index into the tombstone table. May be used as
@@ -257,7 +366,11 @@ public:
 	template <class STORAGE>
 	void rdwr(STORAGE *store)
 	{
-		store->rdwr_short(entry);
+		uint16 id = entry;
+		store->rdwr_short( id );
+		if(  id != entry  ) {
+			set_id( id );
+		}
 		if (entry > next && next < 65534)
 		{
 			// This makes sure that "next" always searches to the end of the array
@@ -270,15 +383,23 @@ public:
 	 * Sets the current id: Needed to recreate stuff via network.
 	 * ATTENTION: This may be harmful. DO not use unless really really needed!
 	 */
-	void set_id(uint16 e) { entry=e; }
+	void set_id(uint16 e)
+	{
+#ifdef DEBUG
+		entry = e;
+		generation = e < size ? generations[e] : 0;
+#else
+		entry = e;
+#endif
+	}
 
 	/**
 	 * Overloaded dereference operator. With this, quickstones can
 	 * be used as if they were pointers.
 	 */
-	T* operator->() const { return data[entry]; }
+	T* operator->() const { check_generation(); return data[entry]; }
 
-	T& operator *() const { return *data[entry]; }
+	T& operator *() const { check_generation(); return *data[entry]; }
 
 	bool operator== (const quickstone_tpl<T> &other) const { return entry == other.entry; }
 
@@ -305,4 +426,12 @@ template <class T> T** quickstone_tpl<T>::data = 0;
 template <class T> uint16 quickstone_tpl<T>::next = 1;
 template <class T> uint16 quickstone_tpl<T>::size = 0;
 
+template <class T> uint16 *quickstone_tpl<T>::free_queue = 0;
+template <class T> uint16 quickstone_tpl<T>::free_first = 0;
+template <class T> uint16 quickstone_tpl<T>::free_count = 0;
+
+#ifdef DEBUG
+template <class T> uint8 *quickstone_tpl<T>::generations = 0;
+#endif
+
 #endif
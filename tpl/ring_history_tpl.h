@@ -0,0 +1,104 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef TPL_RING_HISTORY_TPL_H
+#define TPL_RING_HISTORY_TPL_H
+
+
+#include "../simtypes.h"
+
+
+/**
+ * Monthly history of TYPES values over the last MONTHS months, stored as a
+ * ring buffer indexed by a month epoch (a counter incremented at every month
+ * change by the owner of the epoch). Starting a new month thus costs nothing
+ * per object: the slots of the months passed since the last write are
+ * cleared when the next value is booked, and the getters treat them as zero
+ * until then.
+ *
+ * Age 0 is the current month, age 1 the last month and so on, i.e. the same
+ * order as the [month][type] arrays used in the savegames.
+ *
+ * A 16 bit epoch wraps at 65536, which must be a multiple of MONTHS. Other
+ * history lengths need a 32 bit epoch, which never wraps during a game.
+ */
+template<class T, uint MONTHS, uint TYPES, class epoch_t = uint16> class ring_history_tpl
+{
+	static_assert( MONTHS > 0  &&  ((MONTHS & (MONTHS - 1)) == 0  ||  sizeof(epoch_t) >= 4), "MONTHS must be a power of two for a 16 bit epoch" );
+
+	T data[MONTHS][TYPES];
+
+	/// epoch of the newest month stored in data
+	epoch_t last_epoch;
+
+	static uint slot(epoch_t epoch) { return epoch % MONTHS; }
+
+	/// slot of the month @p age months before @p epoch, @p age must be less than MONTHS
+	static uint slot_before(epoch_t epoch, uint age) { return (slot(epoch) + MONTHS - age) % MONTHS; }
+
+	/// number of months the newest stored month is behind @p epoch
+	epoch_t get_lag(epoch_t epoch) const { return (epoch_t)(epoch - last_epoch); }
+
+public:
+	ring_history_tpl() { clear(0); }
+
+	/// sets everything to zero, the current month is @p epoch
+	void clear(epoch_t epoch)
+	{
+		for(  uint m = 0;  m < MONTHS;  m++  ) {
+			for(  uint t = 0;  t < TYPES;  t++  ) {
+				data[m][t] = 0;
+			}
+		}
+		last_epoch = epoch;
+	}
+
+	/// makes @p epoch the newest month, clearing the slots of the months in between
+	void roll(epoch_t epoch)
+	{
+		const epoch_t lag = get_lag(epoch);
+		if(  lag == 0  ) {
+			return;
+		}
+		if(  lag >= MONTHS  ) {
+			clear(epoch);
+			return;
+		}
+		for(  epoch_t e = last_epoch + 1;  e != (epoch_t)(epoch + 1);  e++  ) {
+			for(  uint t = 0;  t < TYPES;  t++  ) {
+				data[slot(e)][t] = 0;
+			}
+		}
+		last_epoch = epoch;
+	}
+
+	/// @returns the value of @p type @p age months before the month @p epoch
+	T get(uint age, uint type, epoch_t epoch) const
+	{
+		const epoch_t lag = get_lag(epoch);
+		if(  age < lag  ||  age - lag >= MONTHS  ) {
+			return 0;
+		}
+		return data[slot_before(last_epoch, age - lag)][type];
+	}
+
+	/// adds @p amount to @p type in the month @p epoch
+	void book(uint type, T amount, epoch_t epoch)
+	{
+		roll(epoch);
+		data[slot(epoch)][type] += amount;
+	}
+
+	/// sets the value of @p type @p age months before the month @p epoch (used for loading)
+	void set(uint age, uint type, T value, epoch_t epoch)
+	{
+		roll(epoch);
+		if(  age < MONTHS  ) {
+			data[slot_before(epoch, age)][type] = value;
+		}
+	}
+};
+
+#endif
@@ -7,6 +7,7 @@
 
 #include "../dataobj/environment.h"
 #include "../network/memory_rw.h"
+#include "../network/network.h"
 #include "../utils/cbuffer_t.h"
 
 #include <cstring>
@@ -28,6 +29,9 @@ checklist_t::checklist_t() :
 	for(  uint8 i = 0;  i < CHK_DEBUG_SUMS;  i++  ) {
 		debug_sum[i] = 0;
 	}
+	for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+		subsystem_hash[i] = 0;
+	}
 }
 
 checklist_t::checklist_t(const uint32 &hash) :
@@ -46,11 +50,13 @@ checklist_t::checklist_t(const uint32 &hash) :
 	for(  uint8 i = 0;  i < CHK_DEBUG_SUMS;  i++  ) {
 		debug_sum[i] = 0;
 	}
+	for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+		subsystem_hash[i] = 0;
+	}
 }
 
 
-// checklist_t::checklist_t(uint32 _ss, uint32 _st, uint8 _nfc, uint32 _random_seed, uint16 _halt_entry, uint16 _line_entry, uint16 _convoy_entry, uint32* _rands, uint32* _debug_sums)
-checklist_t::checklist_t(uint32 _ss, uint32 _st, uint8 _nfc, uint32 _random_seed, uint16 _halt_entry, uint16 _line_entry, uint16 _convoy_entry, uint32 *_rands, uint32 *_debug_sums) :
+checklist_t::checklist_t(uint32 _ss, uint32 _st, uint8 _nfc, uint32 _random_seed, uint16 _halt_entry, uint16 _line_entry, uint16 _convoy_entry, uint32 *_rands, uint32 *_debug_sums, const uint32 *_subsystem_hashes) :
 	hash(0),
 	random_seed(_random_seed),
 	halt_entry(_halt_entry),
@@ -66,6 +72,9 @@ checklist_t::checklist_t(uint32 _ss, uint32 _st, uint8 _nfc, uint32 _random_seed
 	for(  uint8 i = 0;  i < CHK_DEBUG_SUMS;  i++  ) {
 		debug_sum[i] = _debug_sums[i];
 	}
+	for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+		subsystem_hash[i] = _subsystem_hashes ? _subsystem_hashes[i] : 0;
+	}
 }
 
 
@@ -91,6 +100,7 @@ bool checklist_t::operator==(const checklist_t& other) const
 
 	return ( rands_equal &&
 		debugs_equal &&
+		get_subsystem_mismatches(other) == 0 &&
 		ss == other.ss &&
 		st == other.st &&
 		nfc == other.nfc &&
@@ -102,7 +112,27 @@ bool checklist_t::operator==(const checklist_t& other) const
 }
 
 
-void checklist_t::rdwr(memory_rw_t *buffer)
+uint8 checklist_t::get_subsystem_mismatches(const checklist_t &other) const
+{
+	uint8 mismatches = 0;
+	for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+		// not every sync step carries subsystem hashes, so only compare those calculated at both ends
+		if(  subsystem_hash[i] != 0  &&  other.subsystem_hash[i] != 0  &&  subsystem_hash[i] != other.subsystem_hash[i]  ) {
+			mismatches |= 1 << i;
+		}
+	}
+	return mismatches;
+}
+
+
+const char *checklist_t::get_subsystem_name(uint8 subsystem)
+{
+	static const char *const names[CHK_SUBSYSTEMS] = { "convoys", "halts", "factories", "cities", "ways" };
+	return subsystem < CHK_SUBSYSTEMS ? names[subsystem] : "unknown";
+}
+
+
+void checklist_t::rdwr(memory_rw_t *buffer, uint16 version)
 {
 	buffer->rdwr_long(hash);
 	buffer->rdwr_long(ss);
@@ -120,6 +150,12 @@ void checklist_t::rdwr(memory_rw_t *buffer)
 	for(  uint8 i = 0;  i < CHK_DEBUG_SUMS;  i++  ) {
 		buffer->rdwr_long(debug_sum[i]);
 	}
+	// Hierarchical state hashes: tell which subsystem diverged
+	if(  version >= NETWORK_VERSION_SUBSYSTEM_HASHES  ) {
+		for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+			buffer->rdwr_long(subsystem_hash[i]);
+		}
+	}
 }
 
 
@@ -134,12 +170,14 @@ void checklist_t::print(cbuffer_t &buffer, const char *entity) const
 			"\tssr=%u,%u,%u,%u,%u,%u,%u,%u\n"
 			"\tstr=%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n"
 			"\texr=%u,%u,%u,%u,%u,%u,%u,%u\n"
-			"\tsums=%u,%u,%u,%u,%u,%u,%u,%u,%u,%u]\n",
+			"\tsums=%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n"
+			"\tsubsys=%08x,%08x,%08x,%08x,%08x]\n",
 			entity, ss, st, nfc, hash, random_seed, halt_entry, line_entry, convoy_entry,
 			rand[0], rand[1], rand[2], rand[3], rand[4], rand[5], rand[6], rand[7],
 			rand[8], rand[9], rand[10], rand[11], rand[12], rand[13], rand[14], rand[15], rand[16], rand[17], rand[18], rand[19], rand[20], rand[21], rand[22], rand[23],
 			rand[24], rand[25], rand[26], rand[27], rand[28], rand[29], rand[30], rand[31],
-			debug_sum[0], debug_sum[1], debug_sum[2], debug_sum[3], debug_sum[4], debug_sum[5], debug_sum[6], debug_sum[7], debug_sum[8], debug_sum[9]
+			debug_sum[0], debug_sum[1], debug_sum[2], debug_sum[3], debug_sum[4], debug_sum[5], debug_sum[6], debug_sum[7], debug_sum[8], debug_sum[9],
+			subsystem_hash[CHK_SUB_CONVOYS], subsystem_hash[CHK_SUB_HALTS], subsystem_hash[CHK_SUB_FACTORIES], subsystem_hash[CHK_SUB_CITIES], subsystem_hash[CHK_SUB_WAYS]
 		);
 	}
 }
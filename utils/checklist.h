@@ -15,6 +15,30 @@ class cbuffer_t;
 #define CHK_RANDS 32
 #define CHK_DEBUG_SUMS 10
 
+/**
+ * Per-subsystem state hashes, computed every settings_t::get_subsystem_hash_interval() sync steps.
+ * Each time only one of CHK_HASH_SLICES slices of the objects is hashed, so every
+ * object is covered once in CHK_HASH_SLICES intervals.
+ * A zero hash means "not computed at this sync step" and is never compared.
+ */
+enum checklist_subsystem_t {
+	CHK_SUB_CONVOYS = 0,
+	CHK_SUB_HALTS,
+	CHK_SUB_FACTORIES,
+	CHK_SUB_CITIES,
+	CHK_SUB_WAYS,
+	CHK_SUBSYSTEMS
+};
+
+#define CHK_HASH_INIT (2166136261u)
+#define CHK_HASH_SLICES (8)
+
+/// adds one value to an incremental (FNV-1a style) state hash
+inline uint32 checklist_hash_add(uint32 hash, uint32 value)
+{
+	return (hash ^ value) * 16777619u;
+}
+
 struct checklist_t
 {
 private:
@@ -30,17 +54,24 @@ private:
 
 	uint32 rand[CHK_RANDS];
 	uint32 debug_sum[CHK_DEBUG_SUMS];
+	uint32 subsystem_hash[CHK_SUBSYSTEMS];
 
 public:
 	checklist_t();
 	explicit checklist_t(const uint32 &hash);
-	checklist_t(uint32 _ss, uint32 _st, uint8 _nfc, uint32 _random_seed, uint16 _halt_entry, uint16 _line_entry, uint16 _convoy_entry, uint32 *_rands, uint32 *_debug_sums);
+	checklist_t(uint32 _ss, uint32 _st, uint8 _nfc, uint32 _random_seed, uint16 _halt_entry, uint16 _line_entry, uint16 _convoy_entry, uint32 *_rands, uint32 *_debug_sums, const uint32 *_subsystem_hashes = NULL);
 
 	bool operator == (const checklist_t &other) const;
 	bool operator != (const checklist_t &other) const { return !( *this==other ); }
 
-	void rdwr(memory_rw_t *buffer);
+	/// @returns bit mask of the subsystems (1<<checklist_subsystem_t) whose hashes were computed on both sides and differ
+	uint8 get_subsystem_mismatches(const checklist_t &other) const;
+
+	/// @param version network protocol version of the packet (the subsystem hashes need NETWORK_VERSION_SUBSYSTEM_HASHES)
+	void rdwr(memory_rw_t *buffer, uint16 version);
 	void print(cbuffer_t &buffer, const char *entity) const;
+
+	static const char *get_subsystem_name(uint8 subsystem);
 };
 
 
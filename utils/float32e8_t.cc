@@ -556,6 +556,30 @@ sint32 float32e8_t::to_sint32() const
 	return ms ? -(sint32) rm : (sint32) rm;
 }
 
+sint64 float32e8_t::to_fixed(uint8 frac_bits) const
+{
+	const sint32 shift = e - 32 + frac_bits;
+	if (m == 0 || shift <= -32)
+		return 0;
+	if (shift > 31)
+	{
+		dbg->error("float32e8_t::to_fixed() const", "Cannot convert float32e8_t value %G to fixed point with %d fractional bits", to_double(), frac_bits);
+		return ms ? -(sint64) SINT64_MAX_VALUE : (sint64) SINT64_MAX_VALUE;
+	}
+	const uint64 rm = shift < 0 ? (uint64)(m >> -shift) : (uint64)m << shift;
+	return ms ? -(sint64) rm : (sint64) rm;
+}
+
+float32e8_t float32e8_t::from_fixed(sint64 value, uint8 frac_bits)
+{
+	float32e8_t result(value);
+	if (!result.is_zero())
+	{
+		result.e -= frac_bits;
+	}
+	return result;
+}
+
 
 
 //const string float32e8_t::to_string() const
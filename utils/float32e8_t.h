@@ -323,6 +323,15 @@ public:
 	sint32 to_sint32() const;
 	//const string to_string() const;
 
+	/**
+	 * Converts to a fixed point number with frac_bits fractional bits, truncated towards zero.
+	 * Exact for all values that fit, as the mantissa has 32 bits only.
+	 */
+	sint64 to_fixed(uint8 frac_bits) const;
+
+	/// Converts a fixed point number with frac_bits fractional bits.
+	static float32e8_t from_fixed(sint64 value, uint8 frac_bits);
+
 	explicit inline operator sint32 () const { return to_sint32(); }
 };
 
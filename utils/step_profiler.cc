@@ -0,0 +1,228 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#include "step_profiler.h"
+#include "cbuffer_t.h"
+#include "../simdebug.h"
+
+
+static const char *phase_names[step_profiler_t::MAX_PHASES] = {
+	"step",
+	"private_car_routes",
+	"path_explorer",
+	"threaded_step",
+	"convoys",
+	"cities",
+	"passengers",
+	"factories",
+	"halts",
+	"sync_step",
+	"display"
+};
+
+static const uint32 bucket_limits[step_profiler_t::HISTOGRAM_BUCKETS] = {
+	0, 100, 300, 1000, 3000, 10000, 30000, 100000
+};
+
+// sums of the current step
+static uint64 current[step_profiler_t::MAX_PHASES];
+
+// ring buffer of the sums of the last steps
+static uint32 history[step_profiler_t::MAX_PHASES][step_profiler_t::HISTORY_LENGTH];
+static uint32 history_next = 0;
+static uint32 history_count = 0;
+
+// sums and maxima of all steps since the last reset_totals()
+static uint64 totals[step_profiler_t::MAX_PHASES];
+static uint32 maxima[step_profiler_t::MAX_PHASES];
+static uint32 total_steps = 0;
+
+static FILE *export_file = NULL;
+static bool export_trace = false;
+static bool first_event = true;
+static uint64 export_start = 0;
+// trace events of the current step, written at its end (or earlier, if too many)
+static cbuffer_t events;
+static bool idle = false;
+
+// bytes of trace events kept in memory at most
+#define MAX_EVENTS_BUFFER (1u<<20)
+
+
+void step_profiler_t::add(phase_t phase, uint64 start, uint64 duration)
+{
+	if(  !idle  ) {
+		current[phase] += duration;
+	}
+	if(  export_file  &&  export_trace  ) {
+		events.printf( "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%llu,\"dur\":%llu}",
+			first_event ? "" : ",", phase_names[phase], (unsigned long long)(start - export_start), (unsigned long long)duration );
+		first_event = false;
+		if(  idle  ||  (uint32)events.len() > MAX_EVENTS_BUFFER  ) {
+			fputs( events.get_str(), export_file );
+			events.clear();
+		}
+	}
+}
+
+
+void step_profiler_t::set_idle(bool yesno)
+{
+	idle = yesno;
+}
+
+
+void step_profiler_t::end_step(uint32 step)
+{
+	for(  int p = 0;  p < MAX_PHASES;  p++  ) {
+		history[p][history_next] = (uint32)std::min<uint64>( current[p], 0xFFFFFFFFu );
+		totals[p] += current[p];
+		maxima[p] = std::max( maxima[p], history[p][history_next] );
+	}
+	total_steps ++;
+
+	if(  export_file  ) {
+		if(  export_trace  ) {
+			fputs( events.get_str(), export_file );
+			events.clear();
+		}
+		else {
+			fprintf( export_file, "%u", step );
+			for(  int p = 0;  p < MAX_PHASES;  p++  ) {
+				fprintf( export_file, ",%u", history[p][history_next] );
+			}
+			fputc( '\n', export_file );
+		}
+	}
+
+	memset( current, 0, sizeof(current) );
+	history_next = (history_next + 1) % HISTORY_LENGTH;
+	if(  history_count < HISTORY_LENGTH  ) {
+		history_count ++;
+	}
+}
+
+
+bool step_profiler_t::open_export(const char *filename)
+{
+	close_export();
+	export_file = fopen( filename, "w" );
+	if(  !export_file  ) {
+		dbg->warning( "step_profiler_t::open_export()", "Cannot write step profile to \"%s\"", filename );
+		return false;
+	}
+	const size_t len = strlen( filename );
+	export_trace = len > 5  &&  strcmp( filename + len - 5, ".json" ) == 0;
+	if(  export_trace  ) {
+		fputs( "{\"traceEvents\":[", export_file );
+		first_event = true;
+		export_start = dr_time_us();
+		events.clear();
+	}
+	else {
+		fputs( "step_nr", export_file );
+		for(  int p = 0;  p < MAX_PHASES;  p++  ) {
+			fprintf( export_file, ",%s_us", phase_names[p] );
+		}
+		fputc( '\n', export_file );
+	}
+	dbg->message( "step_profiler_t::open_export()", "Writing step profile to \"%s\"", filename );
+	return true;
+}
+
+
+void step_profiler_t::close_export()
+{
+	if(  export_file  ) {
+		if(  export_trace  ) {
+			fputs( events.get_str(), export_file );
+			events.clear();
+			fputs( "\n]}\n", export_file );
+		}
+		fclose( export_file );
+		export_file = NULL;
+	}
+}
+
+
+const char *step_profiler_t::get_name(phase_t phase)
+{
+	return phase_names[phase];
+}
+
+
+uint32 step_profiler_t::get_last(phase_t phase)
+{
+	return history_count ? history[phase][(history_next + HISTORY_LENGTH - 1) % HISTORY_LENGTH] : 0;
+}
+
+
+void step_profiler_t::get_statistics(phase_t phase, uint32 &mean, uint32 &p95, uint32 &max)
+{
+	mean = p95 = max = 0;
+	if(  history_count == 0  ) {
+		return;
+	}
+	uint32 sorted[HISTORY_LENGTH];
+	uint64 sum = 0;
+	for(  uint32 i = 0;  i < history_count;  i++  ) {
+		sorted[i] = history[phase][i];
+		sum += sorted[i];
+	}
+	std::sort( sorted, sorted + history_count );
+	mean = (uint32)(sum / history_count);
+	p95 = sorted[ (history_count * 95) / 100 ];
+	max = sorted[history_count - 1];
+}
+
+
+void step_profiler_t::get_histogram(phase_t phase, uint32 buckets[HISTOGRAM_BUCKETS])
+{
+	memset( buckets, 0, sizeof(uint32) * HISTOGRAM_BUCKETS );
+	for(  uint32 i = 0;  i < history_count;  i++  ) {
+		uint32 b = HISTOGRAM_BUCKETS - 1;
+		while(  history[phase][i] < bucket_limits[b]  ) {
+			b--;
+		}
+		buckets[b] ++;
+	}
+}
+
+
+uint32 step_profiler_t::get_bucket_limit(uint32 bucket)
+{
+	return bucket_limits[bucket];
+}
+
+
+uint32 step_profiler_t::get_history_count()
+{
+	return history_count;
+}
+
+
+void step_profiler_t::reset_totals()
+{
+	memset( totals, 0, sizeof(totals) );
+	memset( maxima, 0, sizeof(maxima) );
+	total_steps = 0;
+}
+
+
+void step_profiler_t::get_totals(phase_t phase, uint64 &total, uint32 &max)
+{
+	total = totals[phase];
+	max = maxima[phase];
+}
+
+
+uint32 step_profiler_t::get_total_steps()
+{
+	return total_steps;
+}
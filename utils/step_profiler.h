@@ -0,0 +1,106 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef UTILS_STEP_PROFILER_H
+#define UTILS_STEP_PROFILER_H
+
+
+#include "../simtypes.h"
+#include "../sys/simsys.h"
+
+
+/**
+ * Timing of the phases of karte_t::step() and of the frames in between.
+ *
+ * The phases are timed with scope_t from the main thread only. The time of
+ * all scopes of a phase is summed up until the end of the step and then
+ * kept in a rolling history of the last HISTORY_LENGTH steps, from which
+ * the debug frame draws its histograms.
+ *
+ * Optionally every step is also written to a file: one line per step into
+ * a .csv file, or every scope as an event into a Chrome trace (.json),
+ * which can be loaded into chrome://tracing or ui.perfetto.dev.
+ */
+class step_profiler_t
+{
+public:
+	enum phase_t {
+		STEP = 0,
+		PRIVATE_CAR_ROUTES,
+		PATH_EXPLORER,
+		THREADED_STEP,
+		CONVOYS,
+		CITIES,
+		PASSENGERS,
+		FACTORIES,
+		HALTS,
+		SYNC_STEP,
+		DISPLAY,
+		MAX_PHASES
+	};
+
+	enum {
+		HISTORY_LENGTH = 256,
+		/// buckets of the histograms: <100us, <300us, <1ms, ... , >=100ms
+		HISTOGRAM_BUCKETS = 8
+	};
+
+	/// Times the enclosing scope as (part of) phase p
+	class scope_t
+	{
+		const phase_t phase;
+		const uint64 start;
+	public:
+		scope_t(phase_t p) : phase(p), start(dr_time_us()) {}
+		~scope_t() { step_profiler_t::add( phase, start, dr_time_us() - start ); }
+	};
+
+	static void add(phase_t phase, uint64 start, uint64 duration);
+
+	/// Moves the sums of this step into the history and writes them to the export file
+	static void end_step(uint32 step);
+
+	/**
+	 * While idle (paused, or a client waiting for the server), the frames are
+	 * not summed up for the next step, and trace events are written at once.
+	 */
+	static void set_idle(bool yesno);
+
+	/**
+	 * Writes all following steps to @p filename, as Chrome trace if it ends
+	 * with .json, otherwise as csv.
+	 * @returns false, if the file could not be opened
+	 */
+	static bool open_export(const char *filename);
+	static void close_export();
+
+	static const char *get_name(phase_t phase);
+
+	/// @returns time of phase in the last completed step in microseconds
+	static uint32 get_last(phase_t phase);
+
+	/// Mean, maximum and 95th percentile of phase over the history in microseconds
+	static void get_statistics(phase_t phase, uint32 &mean, uint32 &p95, uint32 &max);
+
+	/// Fills @p buckets with the number of steps of the history per time range
+	static void get_histogram(phase_t phase, uint32 buckets[HISTOGRAM_BUCKETS]);
+
+	/// @returns lower limit of bucket in microseconds
+	static uint32 get_bucket_limit(uint32 bucket);
+
+	/// number of steps in the history
+	static uint32 get_history_count();
+
+	/// Restarts the sums over all steps (unlike the history, they are not limited in length)
+	static void reset_totals();
+
+	/// Sum and maximum of phase over all steps since reset_totals() in microseconds
+	static void get_totals(phase_t phase, uint64 &total, uint32 &max);
+
+	/// number of steps since reset_totals()
+	static uint32 get_total_steps();
+};
+
+#endif
@@ -2329,6 +2329,10 @@ sint32 rail_vehicle_t::block_reserver(route_t *route, uint16 start_index, uint16
 			if(!reserving_beyond_a_train && attempt_reservation && !sch1->reserve(cnv->self, ribi_type(route->at(max(1u,i)-1u), route->at(min(route->get_count()-1u,i+1u))), rt, (working_method == time_interval || working_method == time_interval_with_telegraph)))
 			{
 				not_entirely_free = true;
+				if(sch1->get_reserved_convoi().is_bound() && sch1->get_reserved_convoi() != cnv->self)
+				{
+					cnv->set_reservation_blocker(sch1->get_reserved_convoi(), pos);
+				}
 				if (from_call_on)
 				{
 					next_signal_working_method = drive_by_sight;
@@ -2446,6 +2450,10 @@ sint32 rail_vehicle_t::block_reserver(route_t *route, uint16 start_index, uint16
 				if (attempt_reservation)
 				{
 					success = false;
+					if (sch1->get_reserved_convoi().is_bound() && sch1->get_reserved_convoi() != cnv->self)
+					{
+						cnv->set_reservation_blocker(sch1->get_reserved_convoi(), pos);
+					}
 					if (stop_at_station_signal == check_halt)
 					{
 						next_signal_index = first_stop_signal_index;
@@ -200,6 +200,23 @@ public:
 
 	virtual uint32 do_drive(uint32 dist); // basis movement code
 
+	/**
+	 * Moves @p steps_to_do steps on the current tile, which must not be left
+	 * (get_steps() + steps_to_do <= get_steps_next()). The same as do_drive()
+	 * without hopping and bookkeeping, thus only for vehicles behind the front.
+	 */
+	inline void move_on_tile(uint8 steps_to_do)
+	{
+		if(  !get_flag(obj_t::dirty)  ) {
+			mark_image_dirty( image, 0 );
+			set_flag( obj_t::dirty );
+		}
+		steps += steps_to_do;
+		if(  use_calc_height  ) {
+			calc_height();
+		}
+	}
+
 	inline void set_image( image_id b ) { image = b; }
 	image_id get_image() const OVERRIDE {return image;}
 